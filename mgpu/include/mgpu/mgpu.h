@@ -44,6 +44,8 @@ typedef struct MGPUVertexInputStateImpl* MGPUVertexInputState;
 typedef struct MGPUDepthStencilStateImpl* MGPUDepthStencilState;
 typedef struct MGPUCommandListImpl* MGPUCommandList;
 typedef struct MGPURenderCommandEncoderImpl* MGPURenderCommandEncoder;
+typedef struct MGPUComputeCommandEncoderImpl* MGPUComputeCommandEncoder;
+typedef struct MGPUCommandBundleImpl* MGPUCommandBundle;
 typedef struct MGPUSurfaceImpl* MGPUSurface;
 typedef struct MGPUSwapChainImpl* MGPUSwapChain;
 
@@ -75,7 +77,8 @@ typedef enum MGPUResult {
 } MGPUResult;
 
 typedef enum MGPUBackendType {
-  MGPU_BACKEND_TYPE_VULKAN = 0
+  MGPU_BACKEND_TYPE_VULKAN = 0,
+  MGPU_BACKEND_TYPE_NULL = 1
 } MGPUBackend;
 
 typedef enum MGPUQueueType {
@@ -171,8 +174,8 @@ typedef enum MGPUResourceBindingType {
   MGPU_RESOURCE_BINDING_TYPE_STORAGE_TEXTURE = 3,
   MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER = 4,
   MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER = 5,
-//  MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER_DYNAMIC = 6,
-//  MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER_DYNAMIC = 7
+  MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER_DYNAMIC = 6,
+  MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER_DYNAMIC = 7
 } MGPUResourceBindingType;
 
 typedef enum MGPUShaderStageBits {
@@ -348,6 +351,14 @@ typedef struct MGPUTextureUploadRegion {
   uint32_t array_layer_count;
 } MGPUTextureUploadRegion;
 
+// Host-visible memory that is only valid for the work submitted to the queue before its next flush.
+// The memory is recycled automatically once that work has completed on the GPU.
+typedef struct MGPUTransientAllocation {
+  MGPUBuffer buffer;
+  uint64_t offset;
+  void* address;
+} MGPUTransientAllocation;
+
 typedef struct MGPUSurfaceCapabilities {
   // TODO(fleroviux): might want to expose composite alpha, pre-transform and array layer count settings?
   uint32_t min_texture_count;
@@ -367,6 +378,20 @@ typedef struct MGPUSurfaceFormat {
 //   Object creation / descriptor structures               //
 // ======================================================= //
 
+typedef struct MGPUDeviceCreateInfo {
+  // Optional file that the pipeline cache is loaded from on device creation and written back to on device destruction.
+  const char* pipeline_cache_path;
+  // Optional pipeline cache blob, which is used if no pipeline cache could be loaded from pipeline_cache_path.
+  const void* pipeline_cache_data;
+  size_t pipeline_cache_size;
+  // Number of threads that compile pipelines in the background. If zero, pipelines are compiled on the submitting thread.
+  // Otherwise, draws whose pipeline is not ready yet are skipped or use the fallback shader program (see mgpuDeviceSetFallbackShaderProgram).
+  uint32_t pipeline_compiler_thread_count;
+  // Maximum number of graphics pipelines that are kept alive. If exceeded, the least recently used pipelines are destroyed
+  // and compiled again when they are needed the next time. If zero, the number of graphics pipelines is unlimited.
+  uint32_t max_graphics_pipeline_count;
+} MGPUDeviceCreateInfo;
+
 typedef struct MGPUBufferCreateInfo {
   uint64_t size;
   MGPUBufferUsage usage;
@@ -452,11 +477,19 @@ typedef struct MGPUShaderStageCreateInfo {
   const char* entrypoint;
 } MGPUShaderStageCreateInfo;
 
+typedef struct MGPUPushConstantRange {
+  MGPUShaderStage stages;
+  uint32_t offset;
+  uint32_t size;
+} MGPUPushConstantRange;
+
 typedef struct MGPUShaderProgramCreateInfo {
   uint32_t shader_stage_count;
   const MGPUShaderStageCreateInfo* shader_stages;
   uint32_t resource_set_count;
   MGPUResourceSetLayout* resource_set_layouts;
+  uint32_t push_constant_range_count;
+  const MGPUPushConstantRange* push_constant_ranges;
 } MGPUShaderProgramCreateInfo;
 
 typedef struct MGPURasterizerStateCreateInfo {
@@ -587,6 +620,12 @@ typedef struct MGPUPhysicalDeviceLimits {
   uint32_t max_vertex_input_attributes;
   uint32_t max_vertex_input_binding_stride;
   uint32_t max_vertex_input_attribute_offset;
+  uint32_t max_draw_indirect_count;
+  uint32_t max_push_constants_size;
+  uint32_t max_compute_work_group_count[3];
+  uint64_t min_uniform_buffer_offset_alignment;
+  uint64_t min_storage_buffer_offset_alignment;
+  bool draw_indirect_count; // Whether indirect draws may read their draw count from a buffer.
 
   // TODO: resource set limits
 } MGPUPhysicalDeviceLimits;
@@ -620,6 +659,43 @@ typedef struct MGPURenderPassBeginInfo {
   const MGPURenderPassDepthStencilAttachment* depth_stencil_attachment;
 } MGPURenderPassBeginInfo;
 
+typedef struct MGPURenderPassColorAttachmentInfo {
+  MGPUTextureFormat format;
+  MGPULoadOp load_op;
+  MGPUStoreOp store_op;
+} MGPURenderPassColorAttachmentInfo;
+
+typedef struct MGPURenderPassDepthStencilAttachmentInfo {
+  MGPUTextureFormat format;
+  MGPULoadOp depth_load_op;
+  MGPUStoreOp depth_store_op;
+  MGPULoadOp stencil_load_op;
+  MGPUStoreOp stencil_store_op;
+} MGPURenderPassDepthStencilAttachmentInfo;
+
+// Describes the attachments of a render pass without referencing any texture views.
+typedef struct MGPURenderPassInfo {
+  uint32_t color_attachment_count;
+  const MGPURenderPassColorAttachmentInfo* color_attachments;
+  const MGPURenderPassDepthStencilAttachmentInfo* depth_stencil_attachment;
+} MGPURenderPassInfo;
+
+// Any state except for the shader program may be MGPU_NULL_HANDLE, in which case the state that a render pass starts out with is used.
+typedef struct MGPUGraphicsPipelineInfo {
+  MGPUShaderProgram shader_program;
+  MGPURasterizerState rasterizer_state;
+  MGPUInputAssemblyState input_assembly_state;
+  MGPUColorBlendState color_blend_state;
+  MGPUVertexInputState vertex_input_state;
+  MGPUDepthStencilState depth_stencil_state;
+  MGPURenderPassInfo render_pass;
+} MGPUGraphicsPipelineInfo;
+
+typedef struct MGPUCommandListStatistics {
+  uint64_t recorded_command_count;
+  uint64_t elided_command_count;
+} MGPUCommandListStatistics;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -643,7 +719,7 @@ MGPUResult mgpuPhysicalDeviceGetInfo(MGPUPhysicalDevice physical_device, MGPUPhy
 MGPUResult mgpuPhysicalDeviceGetSurfaceCapabilities(MGPUPhysicalDevice physical_device, MGPUSurface surface, MGPUSurfaceCapabilities* surface_capabilities);
 MGPUResult mgpuPhysicalDeviceEnumerateSurfaceFormats(MGPUPhysicalDevice physical_device, MGPUSurface surface, uint32_t* surface_format_count, MGPUSurfaceFormat* surface_formats);
 MGPUResult mgpuPhysicalDeviceEnumerateSurfacePresentModes(MGPUPhysicalDevice physical_device, MGPUSurface surface, uint32_t* present_mode_count, MGPUPresentMode* present_modes);
-MGPUResult mgpuPhysicalDeviceCreateDevice(MGPUPhysicalDevice physical_device, MGPUDevice* device);
+MGPUResult mgpuPhysicalDeviceCreateDevice(MGPUPhysicalDevice physical_device, const MGPUDeviceCreateInfo* create_info, MGPUDevice* device);
 
 // MGPUDevice methods
 MGPUQueue mgpuDeviceGetQueue(MGPUDevice device, MGPUQueueType queue_type);
@@ -660,13 +736,21 @@ MGPUResult mgpuDeviceCreateColorBlendState(MGPUDevice device, const MGPUColorBle
 MGPUResult mgpuDeviceCreateVertexInputState(MGPUDevice device, const MGPUVertexInputStateCreateInfo* create_info, MGPUVertexInputState* vertex_input_state);
 MGPUResult mgpuDeviceCreateDepthStencilState(MGPUDevice device, const MGPUDepthStencilStateCreateInfo* create_info, MGPUDepthStencilState* depth_stencil_state);
 MGPUResult mgpuDeviceCreateCommandList(MGPUDevice device, MGPUCommandList* command_list);
+MGPUResult mgpuDeviceCreateCommandBundle(MGPUDevice device, MGPUCommandList command_list, MGPUCommandBundle* command_bundle);
 MGPUResult mgpuDeviceCreateSwapChain(MGPUDevice device, const MGPUSwapChainCreateInfo* create_info, MGPUSwapChain* swap_chain);
+MGPUResult mgpuDeviceGetPipelineCacheData(MGPUDevice device, size_t* data_size, void* data);
+MGPUResult mgpuDeviceSetFallbackShaderProgram(MGPUDevice device, MGPUShaderProgram shader_program);
+uint32_t mgpuDeviceGetPendingPipelineCompilationCount(MGPUDevice device);
+MGPUResult mgpuDevicePrecompilePipelines(MGPUDevice device, uint32_t pipeline_count, const MGPUGraphicsPipelineInfo* pipelines);
 void mgpuDeviceDestroy(MGPUDevice device);
 
 // MGPUQueue methods
 MGPUResult mgpuQueueSubmitCommandList(MGPUQueue queue, MGPUCommandList command_list);
 MGPUResult mgpuQueueBufferUpload(MGPUQueue queue, MGPUBuffer buffer, uint64_t offset, uint64_t size, const void* data);
 MGPUResult mgpuQueueTextureUpload(MGPUQueue queue, MGPUTexture texture, const MGPUTextureUploadRegion* region, const void* data);
+// Transient resource sets are owned by the queue and must not be destroyed. They are only valid until the next flush of the queue.
+MGPUResult mgpuQueueCreateTransientResourceSet(MGPUQueue queue, const MGPUResourceSetCreateInfo* create_info, MGPUResourceSet* resource_set);
+MGPUResult mgpuQueueAllocateTransient(MGPUQueue queue, uint64_t size, uint64_t alignment, MGPUBufferUsage usage, MGPUTransientAllocation* allocation);
 MGPUResult mgpuQueueFlush(MGPUQueue queue);
 
 // MGPUBuffer methods
@@ -715,6 +799,9 @@ void mgpuDepthStencilStateDestroy(MGPUDepthStencilState depth_stencil_state);
 // MGPUCommandList methods
 MGPUResult mgpuCommandListClear(MGPUCommandList command_list);
 MGPURenderCommandEncoder mgpuCommandListCmdBeginRenderPass(MGPUCommandList command_list, const MGPURenderPassBeginInfo* begin_info);
+MGPUComputeCommandEncoder mgpuCommandListCmdBeginComputePass(MGPUCommandList command_list);
+void mgpuCommandListCmdAppendCommandList(MGPUCommandList command_list, MGPUCommandList child_command_list);
+void mgpuCommandListGetStatistics(MGPUCommandList command_list, MGPUCommandListStatistics* statistics);
 void mgpuCommandListDestroy(MGPUCommandList command_list);
 
 // MGPURenderCommandEncoder methods
@@ -729,10 +816,29 @@ void mgpuRenderCommandEncoderCmdSetScissor(MGPURenderCommandEncoder render_comma
 void mgpuRenderCommandEncoderCmdBindVertexBuffer(MGPURenderCommandEncoder render_command_encoder, uint32_t binding, MGPUBuffer buffer, uint64_t buffer_offset);
 void mgpuRenderCommandEncoderCmdBindIndexBuffer(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, MGPUIndexFormat index_format);
 void mgpuRenderCommandEncoderCmdBindResourceSet(MGPURenderCommandEncoder render_command_encoder, uint32_t index, MGPUResourceSet resource_set);
+void mgpuRenderCommandEncoderCmdBindResourceSetWithDynamicOffsets(MGPURenderCommandEncoder render_command_encoder, uint32_t index, MGPUResourceSet resource_set, uint32_t dynamic_offset_count, const uint32_t* dynamic_offsets);
+void mgpuRenderCommandEncoderCmdPushConstants(MGPURenderCommandEncoder render_command_encoder, uint32_t offset, uint32_t size, const void* data);
 void mgpuRenderCommandEncoderCmdDraw(MGPURenderCommandEncoder render_command_encoder, uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance);
 void mgpuRenderCommandEncoderCmdDrawIndexed(MGPURenderCommandEncoder render_command_encoder, uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance);
+void mgpuRenderCommandEncoderCmdDrawIndirect(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, uint32_t draw_count, uint32_t stride);
+void mgpuRenderCommandEncoderCmdDrawIndexedIndirect(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, uint32_t draw_count, uint32_t stride);
+void mgpuRenderCommandEncoderCmdDrawIndirectCount(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, MGPUBuffer count_buffer, uint64_t count_buffer_offset, uint32_t max_draw_count, uint32_t stride);
+void mgpuRenderCommandEncoderCmdDrawIndexedIndirectCount(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, MGPUBuffer count_buffer, uint64_t count_buffer_offset, uint32_t max_draw_count, uint32_t stride);
+void mgpuRenderCommandEncoderCmdExecuteCommandBundle(MGPURenderCommandEncoder render_command_encoder, MGPUCommandBundle command_bundle);
 void mgpuRenderCommandEncoderClose(MGPURenderCommandEncoder render_command_encoder);
 
+// MGPUComputeCommandEncoder methods
+void mgpuComputeCommandEncoderCmdUseShaderProgram(MGPUComputeCommandEncoder compute_command_encoder, MGPUShaderProgram shader_program);
+void mgpuComputeCommandEncoderCmdBindResourceSet(MGPUComputeCommandEncoder compute_command_encoder, uint32_t index, MGPUResourceSet resource_set);
+void mgpuComputeCommandEncoderCmdBindResourceSetWithDynamicOffsets(MGPUComputeCommandEncoder compute_command_encoder, uint32_t index, MGPUResourceSet resource_set, uint32_t dynamic_offset_count, const uint32_t* dynamic_offsets);
+void mgpuComputeCommandEncoderCmdPushConstants(MGPUComputeCommandEncoder compute_command_encoder, uint32_t offset, uint32_t size, const void* data);
+void mgpuComputeCommandEncoderCmdDispatch(MGPUComputeCommandEncoder compute_command_encoder, uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
+void mgpuComputeCommandEncoderCmdDispatchIndirect(MGPUComputeCommandEncoder compute_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset);
+void mgpuComputeCommandEncoderClose(MGPUComputeCommandEncoder compute_command_encoder);
+
+// MGPUCommandBundle methods
+void mgpuCommandBundleDestroy(MGPUCommandBundle command_bundle);
+
 // MGPUSurface methods
 void mgpuSurfaceDestroy(MGPUSurface surface);
 
@@ -0,0 +1,95 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <vector>
+
+#include "backend/command_list/command_list.hpp"
+#include "backend/texture_view.hpp"
+#include "common/limits.hpp"
+
+namespace mgpu {
+
+/**
+ * A command bundle is a render pass worth of commands, which is translated once and can then be executed
+ * in any render pass with the same attachment formats as the render pass that it was recorded in.
+ */
+class CommandBundleBase : atom::NonCopyable, atom::NonMoveable {
+  public:
+    explicit CommandBundleBase(const CommandList& command_list) {
+      // The command list contains exactly one render pass, which starts with the first command.
+      const auto& command = (const BeginRenderPassCommand&)*command_list.begin();
+
+      for(size_t i = 0; i < command.m_color_attachments.Size(); i++) {
+        const auto texture_view = command.m_color_attachments[i].texture_view;
+        if(texture_view != nullptr) {
+          m_color_attachment_set |= 1u << i;
+          m_color_attachment_formats[i] = texture_view->Format();
+        }
+      }
+
+      if(command.m_have_depth_stencil_attachment) {
+        m_have_depth_stencil_attachment = true;
+        m_depth_stencil_attachment_format = command.m_depth_stencil_attachment.texture_view->Format();
+      }
+
+      if(command.m_have_indirect_draws) {
+        for(const CommandBase& bundle_command : command_list) {
+          switch(bundle_command.m_command_type) {
+            case CommandType::DrawIndirect: AddIndirectBuffers((const DrawIndirectCommand&)bundle_command); break;
+            case CommandType::DrawIndexedIndirect: AddIndirectBuffers((const DrawIndexedIndirectCommand&)bundle_command); break;
+            default: break;
+          }
+        }
+      }
+    }
+
+    virtual ~CommandBundleBase() = default;
+
+    [[nodiscard]] bool IsCompatibleWith(const BeginRenderPassCommand& command) const {
+      u32 color_attachment_set = 0u;
+
+      for(size_t i = 0; i < command.m_color_attachments.Size(); i++) {
+        const auto texture_view = command.m_color_attachments[i].texture_view;
+        if(texture_view != nullptr) {
+          if((m_color_attachment_set & (1u << i)) == 0u || m_color_attachment_formats[i] != texture_view->Format()) {
+            return false;
+          }
+          color_attachment_set |= 1u << i;
+        }
+      }
+
+      if(color_attachment_set != m_color_attachment_set || command.m_have_depth_stencil_attachment != m_have_depth_stencil_attachment) {
+        return false;
+      }
+
+      return !m_have_depth_stencil_attachment || command.m_depth_stencil_attachment.texture_view->Format() == m_depth_stencil_attachment_format;
+    }
+
+    /**
+     * Buffers which indirect draws in the bundle read their arguments or draw counts from.
+     * Barriers cannot be recorded inside of a render pass, so the render pass executing the bundle
+     * has to make these buffers available before it begins.
+     */
+    [[nodiscard]] const std::vector<BufferBase*>& GetIndirectBuffers() const { return m_indirect_buffers; }
+
+  private:
+    template<typename T>
+    void AddIndirectBuffers(const T& command) {
+      m_indirect_buffers.push_back(command.m_buffer);
+      if(command.m_count_buffer != nullptr) {
+        m_indirect_buffers.push_back(command.m_count_buffer);
+      }
+    }
+
+    u32 m_color_attachment_set{};
+    MGPUTextureFormat m_color_attachment_formats[limits::max_color_attachments]{};
+    bool m_have_depth_stencil_attachment{};
+    MGPUTextureFormat m_depth_stencil_attachment_format{};
+    std::vector<BufferBase*> m_indirect_buffers{};
+};
+
+} // namespace mgpu
@@ -8,43 +8,139 @@
 #include <atom/non_moveable.hpp>
 #include <atom/panic.hpp>
 #include <atom/vector_n.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <span>
 #include <utility>
 #include <vector>
 
 #include "backend/device.hpp"
 #include "common/bump_allocator.hpp"
+#include "common/limits.hpp"
 #include "commands.hpp"
+#include "compute_command_encoder.hpp"
+#include "render_command_encoder.hpp"
 
 namespace mgpu {
 
 class CommandList : atom::NonCopyable, atom::NonMoveable {
   public:
-    explicit CommandList(DeviceBase* device) : m_device{device} {
+    static constexpr size_t k_chunk_size = 65536u;
+    static constexpr size_t k_command_alignment = 8u;
+
+    // Commands are packed from the base of a chunk, so a command must fit into a chunk and its size into the u16 in the command header.
+    static constexpr size_t k_max_command_size = std::min<size_t>(k_chunk_size, std::numeric_limits<u16>::max()) & ~(k_command_alignment - 1u);
+
+    static_assert(k_chunk_size % k_command_alignment == 0u);
+
+    // Round the size up so that the following command is suitably aligned as well.
+    template<typename T>
+    static constexpr size_t GetCommandSize(size_t payload_size = 0u) {
+      return (sizeof(T) + payload_size + k_command_alignment - 1u) & ~(k_command_alignment - 1u);
+    }
+
+    struct Statistics {
+      u64 recorded_command_count{};
+      u64 elided_command_count{};
+    };
+
+    /**
+     * Walks the commands in the order in which they were recorded.
+     * Commands are packed tightly within each memory chunk, so this mostly is a linear walk over memory.
+     */
+    class ConstIterator {
+      public:
+        ConstIterator(const CommandList* command_list, size_t chunk, const u8* address)
+            : m_command_list{command_list}
+            , m_chunk{chunk}
+            , m_address{address}
+            , m_chunk_end_address{command_list->m_memory_chunks[chunk].GetCurrentAddress()} {
+          if(m_address == m_chunk_end_address) {
+            AdvanceToNextChunk();
+          }
+        }
+
+        const CommandBase& operator*() const { return *(const CommandBase*)m_address; }
+        const CommandBase* operator->() const { return (const CommandBase*)m_address; }
+
+        ConstIterator& operator++() {
+          m_address += ((const CommandBase*)m_address)->m_command_size;
+          if(m_address == m_chunk_end_address) [[unlikely]] {
+            AdvanceToNextChunk();
+          }
+          return *this;
+        }
+
+        bool operator==(const ConstIterator& other_iterator) const { return m_address == other_iterator.m_address; }
+
+      private:
+        void AdvanceToNextChunk() {
+          while(m_address == m_chunk_end_address && m_chunk < m_command_list->m_active_chunk) {
+            const BumpAllocator& chunk = m_command_list->m_memory_chunks[++m_chunk];
+            m_address = chunk.GetBaseAddress();
+            m_chunk_end_address = chunk.GetCurrentAddress();
+          }
+        }
+
+        const CommandList* m_command_list;
+        size_t m_chunk;
+        const u8* m_address;
+        const u8* m_chunk_end_address;
+    };
+
+    explicit CommandList(DeviceBase* device)
+        : m_device{device}
+        , m_render_command_encoder{this, nullptr}
+        , m_compute_command_encoder{this} {
       m_memory_chunks.emplace_back(k_chunk_size);
       Clear();
     }
 
-    [[nodiscard]] bool HasErrors() const { return m_state.has_errors || m_state.inside_render_pass; }
+    [[nodiscard]] bool HasErrors() const {
+      if(m_state.has_errors || m_state.inside_render_pass || m_state.inside_compute_pass) {
+        return true;
+      }
+
+      for(const CommandList* child_command_list : m_child_command_lists) {
+        // Child command lists may not have children of their own. This keeps submission flat and rules out cycles.
+        if(!child_command_list->m_child_command_lists.empty() || child_command_list->HasErrors()) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    [[nodiscard]] const Statistics& GetStatistics() const { return m_statistics; }
+
+    [[nodiscard]] ConstIterator begin() const {
+      return {this, 0u, m_memory_chunks[0].GetBaseAddress()};
+    }
 
-    [[nodiscard]] const CommandBase* GetListHead() const { return m_head; }
+    [[nodiscard]] ConstIterator end() const {
+      return {this, m_active_chunk, m_memory_chunks[m_active_chunk].GetCurrentAddress()};
+    }
 
     void Clear() {
       m_memory_chunks[0].Reset();
       m_active_chunk = 0u;
-      m_head = nullptr;
-      m_tail = nullptr;
+      m_child_command_lists.clear();
       m_state = {};
+      m_statistics = {};
     }
 
     RenderCommandEncoder* CmdBeginRenderPass(const MGPURenderPassBeginInfo& begin_info) {
-      if(m_state.inside_render_pass) {
+      if(m_state.inside_render_pass || m_state.inside_compute_pass) {
         m_state.has_errors = true;
       }
       m_state.inside_render_pass = true;
 
-      const auto& command = Push<BeginRenderPassCommand>(this, begin_info);
+      BeginRenderPassCommand& command = Push<BeginRenderPassCommand>(begin_info);
 
-      auto& encoder = command.m_render_command_encoder;
+      auto& encoder = m_render_command_encoder;
+      encoder = RenderCommandEncoder{this, &command};
+
+      // The default states only end up in the command list if they are not overridden before the first draw.
       encoder.CmdUseRasterizerState(m_device->GetDefaultRasterizerState());
       encoder.CmdUseColorBlendState(m_device->GetDefaultColorBlendState(begin_info.color_attachment_count));
       encoder.CmdUseInputAssemblyState(m_device->GetDefaultInputAssemblyState());
@@ -53,29 +149,79 @@ class CommandList : atom::NonCopyable, atom::NonMoveable {
       return &encoder;
     }
 
+    ComputeCommandEncoder* CmdBeginComputePass() {
+      if(m_state.inside_render_pass || m_state.inside_compute_pass) {
+        m_state.has_errors = true;
+      }
+      m_state.inside_compute_pass = true;
+
+      Push<BeginComputePassCommand>();
+
+      m_compute_command_encoder = ComputeCommandEncoder{this};
+      return &m_compute_command_encoder;
+    }
+
+    /**
+     * Splices the commands of another command list into this command list at the current position.
+     * Only a reference to the child command list is recorded, which makes this O(1) regardless of the child's size.
+     * The child command list can still be recorded to (on any thread) until this command list is submitted,
+     * but it must not be cleared or destroyed before then.
+     */
+    void CmdAppendCommandList(const CommandList* command_list) {
+      if(m_state.inside_render_pass || m_state.inside_compute_pass || command_list == this) {
+        m_state.has_errors = true;
+      }
+
+      Push<AppendCommandListCommand>(command_list);
+      m_child_command_lists.push_back(command_list);
+    }
+
     void CmdDraw(u32 vertex_count, u32 instance_count, u32 first_vertex, u32 first_instance) {
       // TODO: validate that enough state is bound for the draw.
       Push<DrawCommand>(vertex_count, instance_count, first_vertex, first_instance);
     }
 
     template<typename T, typename... Args>
-    const T& Push(Args&&... args) {
-      T* const command = new(AllocateMemory(sizeof(T))) T{std::forward<Args>(args)...};
-
-      if(m_head == nullptr) {
-        m_head = command;
-        m_tail = command;
-      } else {
-        m_tail->m_next = command;
-        m_tail = command;
+    T& Push(Args&&... args) {
+      constexpr size_t command_size = GetCommandSize<T>();
+
+      static_assert(alignof(T) <= k_command_alignment);
+      static_assert(command_size <= k_max_command_size);
+
+      T* const command = new(AllocateMemory(command_size)) T{std::forward<Args>(args)...};
+      command->m_command_size = (u16)command_size;
+      m_statistics.recorded_command_count++;
+      return *command;
+    }
+
+    /**
+     * Like Push(), but copies a variable-sized payload directly behind the command,
+     * so that commands like push constants do not need to allocate memory elsewhere.
+     */
+    template<typename T, typename... Args>
+    T& PushWithPayload(std::span<const u8> payload, Args&&... args) {
+      const size_t command_size = GetCommandSize<T>(payload.size());
+
+      static_assert(alignof(T) <= k_command_alignment);
+
+      // Callers validate the payload size against these limits, so this only catches bugs.
+      static_assert(GetCommandSize<PushConstantsCommand>(limits::max_push_constants_size) <= k_max_command_size);
+      static_assert(GetCommandSize<BindResourceSetCommand>(limits::max_dynamic_buffer_bindings * sizeof(u32)) <= k_max_command_size);
+      if(command_size > k_max_command_size) [[unlikely]] {
+        ATOM_PANIC("mgpu: command payload is too large: {} bytes", payload.size());
       }
+
+      u8* const address = (u8*)AllocateMemory(command_size);
+      T* const command = new(address) T{std::forward<Args>(args)...};
+      std::memcpy(address + sizeof(T), payload.data(), payload.size());
+      command->m_command_size = (u16)command_size;
+      m_statistics.recorded_command_count++;
       return *command;
     }
 
   private:
-    static constexpr size_t k_chunk_size = 65536u;
-
     friend class RenderCommandEncoder;
+    friend class ComputeCommandEncoder;
 
     void* AllocateMemory(size_t number_of_bytes) {
       void* address = m_memory_chunks[m_active_chunk].Allocate(number_of_bytes);
@@ -94,14 +240,17 @@ class CommandList : atom::NonCopyable, atom::NonMoveable {
     struct State {
       bool has_errors{false};
       bool inside_render_pass{false};
+      bool inside_compute_pass{false};
     };
 
     DeviceBase* m_device;
     std::vector<BumpAllocator> m_memory_chunks{};
     size_t m_active_chunk{};
-    CommandBase* m_head{};
-    CommandBase* m_tail{};
+    std::vector<const CommandList*> m_child_command_lists{};
+    RenderCommandEncoder m_render_command_encoder;
+    ComputeCommandEncoder m_compute_command_encoder;
     State m_state{};
+    Statistics m_statistics{};
 };
 
 }  // namespace mgpu
@@ -8,12 +8,14 @@
 #include <atom/non_copyable.hpp>
 #include <atom/non_moveable.hpp>
 #include <atom/vector_n.hpp>
+#include <span>
 
 #include "common/limits.hpp"
-#include "render_command_encoder.hpp"
 
 namespace mgpu {
 
+class CommandBundleBase;
+class CommandList;
 class TextureViewBase;
 class ShaderProgramBase;
 class RasterizerStateBase;
@@ -24,7 +26,7 @@ class DepthStencilStateBase;
 class BufferBase;
 class ResourceSetBase;
 
-enum class CommandType {
+enum class CommandType : u16 {
   BeginRenderPass,
   EndRenderPass,
   UseShaderProgram,
@@ -38,15 +40,30 @@ enum class CommandType {
   BindVertexBuffer,
   BindIndexBuffer,
   BindResourceSet,
+  PushConstants,
   Draw,
-  DrawIndexed
+  DrawIndexed,
+  DrawIndirect,
+  DrawIndexedIndirect,
+  ExecuteCommandBundle,
+  AppendCommandList,
+  BeginComputePass,
+  EndComputePass,
+  Dispatch,
+  DispatchIndirect
 };
 
+/**
+ * Commands are stored back-to-back in the command list memory.
+ * Each command starts with this small header, which stores the command type and the size of the command in bytes,
+ * so that the next command can be found without storing a pointer to it.
+ * The size is always a multiple of the command alignment, so that every command starts on an aligned address.
+ */
 struct CommandBase : atom::NonCopyable, atom::NonMoveable {
   explicit CommandBase(CommandType command) : m_command_type{command} {}
 
   CommandType m_command_type;
-  CommandBase* m_next{};
+  u16 m_command_size{};
 };
 
 struct BeginRenderPassCommand : CommandBase {
@@ -67,9 +84,8 @@ struct BeginRenderPassCommand : CommandBase {
     uint32_t clear_stencil;
   };
 
-  BeginRenderPassCommand(CommandList* command_list, const MGPURenderPassBeginInfo& begin_info)
-      : CommandBase{CommandType::BeginRenderPass}
-      , m_render_command_encoder{command_list} {
+  explicit BeginRenderPassCommand(const MGPURenderPassBeginInfo& begin_info)
+      : CommandBase{CommandType::BeginRenderPass} {
     for(size_t i = 0; i < begin_info.color_attachment_count; i++) {
       const MGPURenderPassColorAttachment& color_attachment = begin_info.color_attachments[i];
       m_color_attachments.PushBack({
@@ -95,10 +111,16 @@ struct BeginRenderPassCommand : CommandBase {
     }
   }
 
-  mutable RenderCommandEncoder m_render_command_encoder;
   atom::Vector_N<ColorAttachment, limits::max_color_attachments> m_color_attachments{};
   DepthStencilAttachment m_depth_stencil_attachment{};
   bool m_have_depth_stencil_attachment{};
+
+  // Set if the render pass executes command bundles. In that case it does not contain any other commands.
+  bool m_have_command_bundles{};
+
+  // Set if the render pass contains indirect draws, either inline or in command bundles.
+  // The backend then has to make the indirect buffers available before the render pass begins.
+  bool m_have_indirect_draws{};
 };
 
 struct EndRenderPassCommand : CommandBase {
@@ -215,15 +237,36 @@ struct BindIndexBufferCommand : CommandBase {
   MGPUIndexFormat m_index_format;
 };
 
+// The dynamic offsets of the resource set follow directly after the command in the command list.
 struct BindResourceSetCommand : CommandBase {
-  BindResourceSetCommand(u32 index, ResourceSetBase* resource_set)
+  BindResourceSetCommand(u32 index, ResourceSetBase* resource_set, u32 dynamic_offset_count)
       : CommandBase{CommandType::BindResourceSet}
       , m_index{index}
-      , m_resource_set{resource_set} {
+      , m_resource_set{resource_set}
+      , m_dynamic_offset_count{dynamic_offset_count} {
   }
 
+  [[nodiscard]] std::span<const u32> DynamicOffsets() const { return {(const u32*)(this + 1), m_dynamic_offset_count}; }
+
   u32 m_index;
   ResourceSetBase* m_resource_set;
+  u32 m_dynamic_offset_count;
+};
+
+// The data to push follows directly after the command in the command list.
+struct PushConstantsCommand : CommandBase {
+  PushConstantsCommand(MGPUShaderStage stages, u32 offset, u32 size)
+      : CommandBase{CommandType::PushConstants}
+      , m_stages{stages}
+      , m_offset{offset}
+      , m_size{size} {
+  }
+
+  [[nodiscard]] const void* Data() const { return this + 1; }
+
+  MGPUShaderStage m_stages;
+  u32 m_offset;
+  u32 m_size;
 };
 
 struct DrawCommand : CommandBase {
@@ -258,4 +301,93 @@ struct DrawIndexedCommand: CommandBase {
   u32 m_first_instance;
 };
 
+// The count buffer is optional. If it is set, the draw count is read from it and m_draw_count is the maximum draw count.
+struct DrawIndirectCommand : CommandBase {
+  DrawIndirectCommand(BufferBase* buffer, u64 buffer_offset, BufferBase* count_buffer, u64 count_buffer_offset, u32 draw_count, u32 stride)
+      : CommandBase{CommandType::DrawIndirect}
+      , m_buffer{buffer}
+      , m_buffer_offset{buffer_offset}
+      , m_count_buffer{count_buffer}
+      , m_count_buffer_offset{count_buffer_offset}
+      , m_draw_count{draw_count}
+      , m_stride{stride} {
+  }
+
+  BufferBase* m_buffer;
+  u64 m_buffer_offset;
+  BufferBase* m_count_buffer;
+  u64 m_count_buffer_offset;
+  u32 m_draw_count;
+  u32 m_stride;
+};
+
+struct DrawIndexedIndirectCommand : CommandBase {
+  DrawIndexedIndirectCommand(BufferBase* buffer, u64 buffer_offset, BufferBase* count_buffer, u64 count_buffer_offset, u32 draw_count, u32 stride)
+      : CommandBase{CommandType::DrawIndexedIndirect}
+      , m_buffer{buffer}
+      , m_buffer_offset{buffer_offset}
+      , m_count_buffer{count_buffer}
+      , m_count_buffer_offset{count_buffer_offset}
+      , m_draw_count{draw_count}
+      , m_stride{stride} {
+  }
+
+  BufferBase* m_buffer;
+  u64 m_buffer_offset;
+  BufferBase* m_count_buffer;
+  u64 m_count_buffer_offset;
+  u32 m_draw_count;
+  u32 m_stride;
+};
+
+struct ExecuteCommandBundleCommand : CommandBase {
+  explicit ExecuteCommandBundleCommand(const CommandBundleBase* command_bundle)
+      : CommandBase{CommandType::ExecuteCommandBundle}
+      , m_command_bundle{command_bundle} {
+  }
+
+  const CommandBundleBase* m_command_bundle;
+};
+
+struct AppendCommandListCommand : CommandBase {
+  explicit AppendCommandListCommand(const CommandList* command_list)
+      : CommandBase{CommandType::AppendCommandList}
+      , m_command_list{command_list} {
+  }
+
+  const CommandList* m_command_list;
+};
+
+struct BeginComputePassCommand : CommandBase {
+  BeginComputePassCommand() : CommandBase{CommandType::BeginComputePass} {}
+};
+
+struct EndComputePassCommand : CommandBase {
+  EndComputePassCommand() : CommandBase{CommandType::EndComputePass} {}
+};
+
+struct DispatchCommand : CommandBase {
+  DispatchCommand(u32 group_count_x, u32 group_count_y, u32 group_count_z)
+      : CommandBase{CommandType::Dispatch}
+      , m_group_count_x{group_count_x}
+      , m_group_count_y{group_count_y}
+      , m_group_count_z{group_count_z} {
+  }
+
+  u32 m_group_count_x;
+  u32 m_group_count_y;
+  u32 m_group_count_z;
+};
+
+struct DispatchIndirectCommand : CommandBase {
+  DispatchIndirectCommand(BufferBase* buffer, u64 buffer_offset)
+      : CommandBase{CommandType::DispatchIndirect}
+      , m_buffer{buffer}
+      , m_buffer_offset{buffer_offset} {
+  }
+
+  BufferBase* m_buffer;
+  u64 m_buffer_offset;
+};
+
 } // namespace mgpu
@@ -0,0 +1,105 @@
+
+#include "backend/buffer.hpp"
+#include "backend/pipeline_state/shader_program.hpp"
+#include "backend/resource_set.hpp"
+#include "command_list.hpp"
+#include "compute_command_encoder.hpp"
+
+namespace mgpu {
+
+void ComputeCommandEncoder::CmdUseShaderProgram(ShaderProgramBase* shader_program) {
+  // Graphics shader programs cannot be used for dispatches.
+  if(shader_program == nullptr || shader_program->GetStages() != MGPU_SHADER_STAGE_COMPUTE) {
+    m_command_list->m_state.has_errors = true;
+    return;
+  }
+
+  if(shader_program == m_shader_program) {
+    m_command_list->m_statistics.elided_command_count++;
+    return;
+  }
+  m_command_list->Push<UseShaderProgramCommand>(shader_program);
+  m_shader_program = shader_program;
+
+  // Switching to a shader program with an incompatible layout may disturb the bound resource sets,
+  // so we cannot assume that they still are bound after the switch.
+  for(auto& resource_set : m_resource_sets) resource_set = nullptr;
+}
+
+void ComputeCommandEncoder::CmdBindResourceSet(u32 index, ResourceSetBase* resource_set, std::span<const u32> dynamic_offsets) {
+  // This also requires the number of offsets to match the number of dynamic bindings, which bounds the size of the payload.
+  if(resource_set == nullptr || !resource_set->AreDynamicOffsetsValid(m_command_list->m_device->Limits(), dynamic_offsets)) {
+    m_command_list->m_state.has_errors = true;
+    return;
+  }
+
+  // Rebinding a resource set with dynamic offsets is how the offsets are changed, so it is never redundant.
+  if(index < k_max_tracked_resource_sets) {
+    if(m_resource_sets[index] == resource_set && dynamic_offsets.empty()) {
+      m_command_list->m_statistics.elided_command_count++;
+      return;
+    }
+    m_resource_sets[index] = resource_set;
+  }
+  m_command_list->PushWithPayload<BindResourceSetCommand>(
+    {(const u8*)dynamic_offsets.data(), dynamic_offsets.size_bytes()}, index, resource_set, (u32)dynamic_offsets.size());
+}
+
+void ComputeCommandEncoder::CmdPushConstants(u32 offset, u32 size, const void* data) {
+  const u32 max_push_constants_size = m_command_list->m_device->Limits().max_push_constants_size;
+
+  MGPUShaderStage stages = 0;
+  if(
+    m_shader_program != nullptr && data != nullptr &&
+    size != 0u && size <= max_push_constants_size && offset <= max_push_constants_size - size &&
+    offset % sizeof(u32) == 0u && size % sizeof(u32) == 0u
+  ) {
+    stages = m_shader_program->GetPushConstantStages(offset, size);
+  }
+
+  // Do not record invalid push constants at all, since the payload size is not known to be sane.
+  if(stages == 0) {
+    m_command_list->m_state.has_errors = true;
+    return;
+  }
+  m_command_list->PushWithPayload<PushConstantsCommand>({(const u8*)data, size}, stages, offset, size);
+}
+
+void ComputeCommandEncoder::CmdDispatch(u32 group_count_x, u32 group_count_y, u32 group_count_z) {
+  const u32* max_group_count = m_command_list->m_device->Limits().max_compute_work_group_count;
+  if(group_count_x > max_group_count[0] || group_count_y > max_group_count[1] || group_count_z > max_group_count[2]) {
+    m_command_list->m_state.has_errors = true;
+    return;
+  }
+
+  if(m_shader_program == nullptr) {
+    m_command_list->m_state.has_errors = true;
+    return;
+  }
+  m_command_list->Push<DispatchCommand>(group_count_x, group_count_y, group_count_z);
+}
+
+void ComputeCommandEncoder::CmdDispatchIndirect(BufferBase* buffer, u64 buffer_offset) {
+  // The buffer holds the three group counts as 32-bit unsigned integers.
+  constexpr u64 dispatch_arguments_size = 3u * sizeof(u32);
+
+  if(
+    m_shader_program == nullptr ||
+    !(buffer->Usage() & MGPU_BUFFER_USAGE_INDIRECT_BUFFER) ||
+    buffer_offset % sizeof(u32) != 0u ||
+    buffer_offset > buffer->Size() ||
+    buffer->Size() - buffer_offset < dispatch_arguments_size
+  ) {
+    m_command_list->m_state.has_errors = true;
+    return;
+  }
+  m_command_list->Push<DispatchIndirectCommand>(buffer, buffer_offset);
+}
+
+void ComputeCommandEncoder::Close() {
+  m_command_list->Push<EndComputePassCommand>();
+  m_command_list->m_state.inside_compute_pass = false;
+  m_command_list = nullptr;
+}
+
+} // namespace mgpu
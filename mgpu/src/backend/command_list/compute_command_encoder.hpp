@@ -0,0 +1,39 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
+#include <span>
+
+namespace mgpu {
+
+class CommandList;
+class ShaderProgramBase;
+class BufferBase;
+class ResourceSetBase;
+
+/**
+ * Like the render command encoder, the compute command encoder shadows the state that is bound in the current compute pass
+ * and drops commands which would not change it.
+ * Storage resources that are written by a dispatch are made visible to the following dispatches by the backend.
+ */
+class ComputeCommandEncoder {
+  public:
+    explicit ComputeCommandEncoder(CommandList* command_list) : m_command_list{command_list} {}
+
+    void CmdUseShaderProgram(ShaderProgramBase* shader_program);
+    void CmdBindResourceSet(u32 index, ResourceSetBase* resource_set, std::span<const u32> dynamic_offsets);
+    void CmdPushConstants(u32 offset, u32 size, const void* data);
+    void CmdDispatch(u32 group_count_x, u32 group_count_y, u32 group_count_z);
+    void CmdDispatchIndirect(BufferBase* buffer, u64 buffer_offset);
+    void Close();
+
+  private:
+    static constexpr size_t k_max_tracked_resource_sets = 8u;
+
+    CommandList* m_command_list;
+    ShaderProgramBase* m_shader_program{};
+    ResourceSetBase* m_resource_sets[k_max_tracked_resource_sets]{};
+};
+
+} // namespace mgpu
@@ -1,59 +1,176 @@
 
+#include <limits>
+
+#include "backend/buffer.hpp"
+#include "backend/command_bundle.hpp"
+#include "backend/pipeline_state/shader_program.hpp"
+#include "backend/resource_set.hpp"
 #include "command_list.hpp"
 #include "render_command_encoder.hpp"
 
 namespace mgpu {
 
 void RenderCommandEncoder::CmdUseShaderProgram(ShaderProgramBase* shader_program) {
-  m_command_list->Push<UseShaderProgramCommand>(shader_program);
+  if(shader_program == m_shader_program) {
+    m_command_list->m_statistics.elided_command_count++;
+    return;
+  }
+  Push<UseShaderProgramCommand>(shader_program);
+  m_shader_program = shader_program;
+
+  // Switching to a shader program with an incompatible layout may disturb the bound resource sets,
+  // so we cannot assume that they still are bound after the switch.
+  for(auto& resource_set : m_resource_sets) resource_set = nullptr;
 }
 
 void RenderCommandEncoder::CmdUseRasterizerState(RasterizerStateBase* rasterizer_state) {
-  m_command_list->Push<UseRasterizerStateCommand>(rasterizer_state);
+  SetDeferredState(m_rasterizer_state, rasterizer_state);
 }
 
 void RenderCommandEncoder::CmdUseInputAssemblyState(InputAssemblyStateBase* input_assembly_state) {
-  m_command_list->Push<UseInputAssemblyStateCommand>(input_assembly_state);
+  SetDeferredState(m_input_assembly_state, input_assembly_state);
 }
 
 void RenderCommandEncoder::CmdUseColorBlendState(ColorBlendStateBase* color_blend_state) {
-  m_command_list->Push<UseColorBlendStateCommand>(color_blend_state);
+  SetDeferredState(m_color_blend_state, color_blend_state);
 }
 
 void RenderCommandEncoder::CmdUseVertexInputState(VertexInputStateBase* vertex_input_state) {
-  m_command_list->Push<UseVertexInputStateCommand>(vertex_input_state);
+  SetDeferredState(m_vertex_input_state, vertex_input_state);
 }
 
 void RenderCommandEncoder::CmdUseDepthStencilState(DepthStencilStateBase* depth_stencil_state) {
-  m_command_list->Push<UseDepthStencilStateCommand>(depth_stencil_state);
+  SetDeferredState(m_depth_stencil_state, depth_stencil_state);
 }
 
 void RenderCommandEncoder::CmdSetViewport(f32 x, f32 y, f32 width, f32 height) {
-  m_command_list->Push<SetViewportCommand>(x, y, width, height);
+  if(m_have_viewport && m_viewport.x == x && m_viewport.y == y && m_viewport.width == width && m_viewport.height == height) {
+    m_command_list->m_statistics.elided_command_count++;
+    return;
+  }
+  Push<SetViewportCommand>(x, y, width, height);
+  m_viewport = {x, y, width, height};
+  m_have_viewport = true;
 }
 
 void RenderCommandEncoder::CmdSetScissor(i32 x, i32 y, u32 width, u32 height) {
-  m_command_list->Push<SetScissorCommand>(x, y, width, height);
+  if(m_have_scissor && m_scissor.x == x && m_scissor.y == y && m_scissor.width == width && m_scissor.height == height) {
+    m_command_list->m_statistics.elided_command_count++;
+    return;
+  }
+  Push<SetScissorCommand>(x, y, width, height);
+  m_scissor = {x, y, width, height};
+  m_have_scissor = true;
 }
 
 void RenderCommandEncoder::CmdBindVertexBuffer(u32 binding, BufferBase* buffer, u64 buffer_offset) {
-  m_command_list->Push<BindVertexBufferCommand>(binding, buffer, buffer_offset);
+  if(binding < limits::max_vertex_input_bindings) {
+    VertexBufferBinding& vertex_buffer = m_vertex_buffers[binding];
+    if(vertex_buffer.buffer == buffer && vertex_buffer.buffer_offset == buffer_offset) {
+      m_command_list->m_statistics.elided_command_count++;
+      return;
+    }
+    vertex_buffer = {buffer, buffer_offset};
+  }
+  Push<BindVertexBufferCommand>(binding, buffer, buffer_offset);
 }
 
 void RenderCommandEncoder::CmdBindIndexBuffer(BufferBase* buffer, u64 buffer_offset, MGPUIndexFormat index_format) {
-  m_command_list->Push<BindIndexBufferCommand>(buffer, buffer_offset, index_format);
+  if(m_index_buffer.buffer == buffer && m_index_buffer.buffer_offset == buffer_offset && m_index_buffer.index_format == index_format) {
+    m_command_list->m_statistics.elided_command_count++;
+    return;
+  }
+  Push<BindIndexBufferCommand>(buffer, buffer_offset, index_format);
+  m_index_buffer = {buffer, buffer_offset, index_format};
+}
+
+void RenderCommandEncoder::CmdBindResourceSet(u32 index, ResourceSetBase* resource_set, std::span<const u32> dynamic_offsets) {
+  // This also requires the number of offsets to match the number of dynamic bindings, which bounds the size of the payload.
+  if(resource_set == nullptr || !resource_set->AreDynamicOffsetsValid(m_command_list->m_device->Limits(), dynamic_offsets)) {
+    m_command_list->m_state.has_errors = true;
+    return;
+  }
+
+  // Rebinding a resource set with dynamic offsets is how the offsets are changed, so it is never redundant.
+  if(index < k_max_tracked_resource_sets) {
+    if(m_resource_sets[index] == resource_set && dynamic_offsets.empty()) {
+      m_command_list->m_statistics.elided_command_count++;
+      return;
+    }
+    m_resource_sets[index] = resource_set;
+  }
+
+  if(m_begin_render_pass_command->m_have_command_bundles) {
+    m_command_list->m_state.has_errors = true;
+  }
+  m_command_list->PushWithPayload<BindResourceSetCommand>(
+    {(const u8*)dynamic_offsets.data(), dynamic_offsets.size_bytes()}, index, resource_set, (u32)dynamic_offsets.size());
+  m_have_inline_commands = true;
 }
 
-void RenderCommandEncoder::CmdBindResourceSet(u32 index, ResourceSetBase* resource_set) {
-  m_command_list->Push<BindResourceSetCommand>(index, resource_set);
+void RenderCommandEncoder::CmdPushConstants(u32 offset, u32 size, const void* data) {
+  const u32 max_push_constants_size = m_command_list->m_device->Limits().max_push_constants_size;
+
+  MGPUShaderStage stages = 0;
+  if(
+    m_shader_program != nullptr && data != nullptr &&
+    size != 0u && size <= max_push_constants_size && offset <= max_push_constants_size - size &&
+    offset % sizeof(u32) == 0u && size % sizeof(u32) == 0u
+  ) {
+    stages = m_shader_program->GetPushConstantStages(offset, size);
+  }
+
+  // Do not record invalid push constants at all, since the payload size is not known to be sane.
+  if(stages == 0) {
+    m_command_list->m_state.has_errors = true;
+    return;
+  }
+
+  if(m_begin_render_pass_command->m_have_command_bundles) {
+    m_command_list->m_state.has_errors = true;
+  }
+  m_command_list->PushWithPayload<PushConstantsCommand>({(const u8*)data, size}, stages, offset, size);
+  m_have_inline_commands = true;
 }
 
 void RenderCommandEncoder::CmdDraw(u32 vertex_count, u32 instance_count, u32 first_vertex, u32 first_instance) {
-  m_command_list->Push<DrawCommand>(vertex_count, instance_count, first_vertex, first_instance);
+  RecordDeferredStates();
+  Push<DrawCommand>(vertex_count, instance_count, first_vertex, first_instance);
 }
 
 void RenderCommandEncoder::CmdDrawIndexed(u32 index_count, u32 instance_count, u32 first_index, i32 vertex_offset, u32 first_instance) {
-  m_command_list->Push<DrawIndexedCommand>(index_count, instance_count, first_index, vertex_offset, first_instance);
+  RecordDeferredStates();
+  Push<DrawIndexedCommand>(index_count, instance_count, first_index, vertex_offset, first_instance);
+}
+
+void RenderCommandEncoder::CmdDrawIndirect(BufferBase* buffer, u64 buffer_offset, BufferBase* count_buffer, u64 count_buffer_offset, u32 draw_count, u32 stride) {
+  // The buffer holds vertex count, instance count, first vertex and first instance of each draw as 32-bit unsigned integers.
+  ValidateIndirectDraw(buffer, buffer_offset, count_buffer, count_buffer_offset, draw_count, stride, 4u * sizeof(u32));
+  RecordDeferredStates();
+  Push<DrawIndirectCommand>(buffer, buffer_offset, count_buffer, count_buffer_offset, draw_count, stride);
+  m_begin_render_pass_command->m_have_indirect_draws = true;
+}
+
+void RenderCommandEncoder::CmdDrawIndexedIndirect(BufferBase* buffer, u64 buffer_offset, BufferBase* count_buffer, u64 count_buffer_offset, u32 draw_count, u32 stride) {
+  // The buffer holds index count, instance count, first index, vertex offset and first instance of each draw as 32-bit integers.
+  ValidateIndirectDraw(buffer, buffer_offset, count_buffer, count_buffer_offset, draw_count, stride, 5u * sizeof(u32));
+  RecordDeferredStates();
+  Push<DrawIndexedIndirectCommand>(buffer, buffer_offset, count_buffer, count_buffer_offset, draw_count, stride);
+  m_begin_render_pass_command->m_have_indirect_draws = true;
+}
+
+void RenderCommandEncoder::CmdExecuteCommandBundle(const CommandBundleBase* command_bundle) {
+  if(m_have_inline_commands || !command_bundle->IsCompatibleWith(*m_begin_render_pass_command)) {
+    m_command_list->m_state.has_errors = true;
+  }
+  m_command_list->Push<ExecuteCommandBundleCommand>(command_bundle);
+  m_begin_render_pass_command->m_have_command_bundles = true;
+  if(!command_bundle->GetIndirectBuffers().empty()) {
+    m_begin_render_pass_command->m_have_indirect_draws = true;
+  }
+
+  // Bundles do not inherit any state from the render pass and do not leave any state behind either.
+  *this = RenderCommandEncoder{m_command_list, m_begin_render_pass_command};
 }
 
 void RenderCommandEncoder::Close() {
@@ -62,4 +179,90 @@ void RenderCommandEncoder::Close() {
   m_command_list = nullptr;
 }
 
+template<typename T>
+void RenderCommandEncoder::SetDeferredState(DeferredState<T>& state, T* value) {
+  // A state which was set but not consumed by a draw yet is simply overwritten.
+  if(state.dirty) {
+    m_command_list->m_statistics.elided_command_count++;
+  }
+  state.pending = value;
+  state.dirty = true;
+}
+
+template<typename TCommand, typename T>
+void RenderCommandEncoder::RecordDeferredState(DeferredState<T>& state) {
+  if(!state.dirty) {
+    return;
+  }
+  if(state.pending != state.recorded) {
+    Push<TCommand>(state.pending);
+    state.recorded = state.pending;
+  } else {
+    m_command_list->m_statistics.elided_command_count++;
+  }
+  state.dirty = false;
+}
+
+template<typename T, typename... Args>
+void RenderCommandEncoder::Push(Args&&... args) {
+  if(m_begin_render_pass_command->m_have_command_bundles) {
+    m_command_list->m_state.has_errors = true;
+  }
+  m_command_list->Push<T>(std::forward<Args>(args)...);
+  m_have_inline_commands = true;
+}
+
+void RenderCommandEncoder::ValidateIndirectDraw(
+  BufferBase* buffer,
+  u64 buffer_offset,
+  BufferBase* count_buffer,
+  u64 count_buffer_offset,
+  u32 draw_count,
+  u32 stride,
+  u32 draw_arguments_size
+) {
+  const MGPUPhysicalDeviceLimits& limits = m_command_list->m_device->Limits();
+
+  bool valid = (buffer->Usage() & MGPU_BUFFER_USAGE_INDIRECT_BUFFER) && buffer_offset % sizeof(u32) == 0u;
+
+  // The stride only matters if there is more than one draw, but the count buffer may provide any number of draws.
+  if(draw_count > 1u || count_buffer != nullptr) {
+    valid = valid && stride % sizeof(u32) == 0u && stride >= draw_arguments_size;
+  }
+
+  // Check the range against the remaining size, so that offsets close to the end of the u64 range cannot wrap around.
+  if(draw_count > 0u) {
+    // The product of two u32 always fits into a u64, so the offset of the last draw cannot overflow.
+    static_assert(std::numeric_limits<u32>::max() <= std::numeric_limits<u64>::max() / std::numeric_limits<u32>::max());
+    const u64 last_draw_offset = (u64)(draw_count - 1u) * stride;
+    valid = valid &&
+      buffer_offset <= buffer->Size() &&
+      buffer->Size() - buffer_offset >= draw_arguments_size &&
+      buffer->Size() - buffer_offset - draw_arguments_size >= last_draw_offset;
+  }
+
+  if(count_buffer != nullptr) {
+    valid = valid &&
+      limits.draw_indirect_count &&
+      (count_buffer->Usage() & MGPU_BUFFER_USAGE_INDIRECT_BUFFER) &&
+      count_buffer_offset % sizeof(u32) == 0u &&
+      count_buffer_offset <= count_buffer->Size() &&
+      count_buffer->Size() - count_buffer_offset >= sizeof(u32);
+  } else {
+    valid = valid && draw_count <= limits.max_draw_indirect_count;
+  }
+
+  if(!valid) {
+    m_command_list->m_state.has_errors = true;
+  }
+}
+
+void RenderCommandEncoder::RecordDeferredStates() {
+  RecordDeferredState<UseRasterizerStateCommand>(m_rasterizer_state);
+  RecordDeferredState<UseInputAssemblyStateCommand>(m_input_assembly_state);
+  RecordDeferredState<UseColorBlendStateCommand>(m_color_blend_state);
+  RecordDeferredState<UseVertexInputStateCommand>(m_vertex_input_state);
+  RecordDeferredState<UseDepthStencilStateCommand>(m_depth_stencil_state);
+}
+
 } // namespace mgpu
@@ -1,11 +1,17 @@
 
 #pragma once
 
+#include <mgpu/mgpu.h>
 #include <atom/integer.hpp>
+#include <span>
 #include <atom/float.hpp>
 
+#include "common/limits.hpp"
+
 namespace mgpu {
 
+struct BeginRenderPassCommand;
+class CommandBundleBase;
 class CommandList;
 //class TextureViewBase;
 class ShaderProgramBase;
@@ -17,9 +23,16 @@ class DepthStencilStateBase;
 class BufferBase;
 class ResourceSetBase;
 
+/**
+ * The encoder shadows the state that is bound in the current render pass and drops commands which would not change it.
+ * Pipeline states (other than the shader program) are only recorded once a draw actually needs them,
+ * so that states which are overwritten before the next draw never reach the command list.
+ */
 class RenderCommandEncoder {
   public:
-    explicit RenderCommandEncoder(CommandList* command_list) : m_command_list{command_list} {
+    RenderCommandEncoder(CommandList* command_list, BeginRenderPassCommand* begin_render_pass_command)
+        : m_command_list{command_list}
+        , m_begin_render_pass_command{begin_render_pass_command} {
     }
 
     void CmdUseShaderProgram(ShaderProgramBase* shader_program);
@@ -32,13 +45,79 @@ class RenderCommandEncoder {
     void CmdSetScissor(i32 x, i32 y, u32 width, u32 height);
     void CmdBindVertexBuffer(u32 binding, BufferBase* buffer, u64 buffer_offset);
     void CmdBindIndexBuffer(BufferBase* buffer, u64 buffer_offset, MGPUIndexFormat index_format);
-    void CmdBindResourceSet(u32 index, ResourceSetBase* resource_set);
+    void CmdBindResourceSet(u32 index, ResourceSetBase* resource_set, std::span<const u32> dynamic_offsets);
+    void CmdPushConstants(u32 offset, u32 size, const void* data);
     void CmdDraw(u32 vertex_count, u32 instance_count, u32 first_vertex, u32 first_instance);
     void CmdDrawIndexed(u32 index_count, u32 instance_count, u32 first_index, i32 vertex_offset, u32 first_instance);
+    void CmdDrawIndirect(BufferBase* buffer, u64 buffer_offset, BufferBase* count_buffer, u64 count_buffer_offset, u32 draw_count, u32 stride);
+    void CmdDrawIndexedIndirect(BufferBase* buffer, u64 buffer_offset, BufferBase* count_buffer, u64 count_buffer_offset, u32 draw_count, u32 stride);
+    void CmdExecuteCommandBundle(const CommandBundleBase* command_bundle);
     void Close();
 
   private:
+    static constexpr size_t k_max_tracked_resource_sets = 8u;
+
+    template<typename T>
+    struct DeferredState {
+      T* pending{};
+      T* recorded{};
+      bool dirty{false};
+    };
+
+    template<typename T>
+    void SetDeferredState(DeferredState<T>& state, T* value);
+
+    template<typename TCommand, typename T>
+    void RecordDeferredState(DeferredState<T>& state);
+
+    void RecordDeferredStates();
+
+    void ValidateIndirectDraw(BufferBase* buffer, u64 buffer_offset, BufferBase* count_buffer, u64 count_buffer_offset, u32 draw_count, u32 stride, u32 draw_arguments_size);
+
+    template<typename T, typename... Args>
+    void Push(Args&&... args);
+
     CommandList* m_command_list;
+    BeginRenderPassCommand* m_begin_render_pass_command;
+
+    // A render pass may either execute command bundles or contain commands of its own, but not both.
+    bool m_have_inline_commands{false};
+
+    ShaderProgramBase* m_shader_program{};
+    DeferredState<RasterizerStateBase> m_rasterizer_state{};
+    DeferredState<InputAssemblyStateBase> m_input_assembly_state{};
+    DeferredState<ColorBlendStateBase> m_color_blend_state{};
+    DeferredState<VertexInputStateBase> m_vertex_input_state{};
+    DeferredState<DepthStencilStateBase> m_depth_stencil_state{};
+
+    struct Viewport {
+      f32 x;
+      f32 y;
+      f32 width;
+      f32 height;
+    } m_viewport{};
+    bool m_have_viewport{false};
+
+    struct Scissor {
+      i32 x;
+      i32 y;
+      u32 width;
+      u32 height;
+    } m_scissor{};
+    bool m_have_scissor{false};
+
+    struct VertexBufferBinding {
+      BufferBase* buffer;
+      u64 buffer_offset;
+    } m_vertex_buffers[limits::max_vertex_input_bindings]{};
+
+    struct IndexBufferBinding {
+      BufferBase* buffer;
+      u64 buffer_offset;
+      MGPUIndexFormat index_format;
+    } m_index_buffer{};
+
+    ResourceSetBase* m_resource_sets[k_max_tracked_resource_sets]{};
 };
 
-} // namespace mgpu
\ No newline at end of file
+} // namespace mgpu
@@ -1,11 +1,49 @@
 
 #include <atom/vector_n.hpp>
+#include <mutex>
 
+#include "backend/pipeline_state/color_blend_state.hpp"
+#include "backend/pipeline_state/depth_stencil_state.hpp"
+#include "backend/pipeline_state/input_assembly_state.hpp"
+#include "backend/pipeline_state/rasterizer_state.hpp"
+#include "backend/pipeline_state/vertex_input_state.hpp"
 #include "device.hpp"
 
 namespace mgpu {
 
+Result<RasterizerStateBase*> DeviceBase::CreateRasterizerState(const MGPURasterizerStateCreateInfo& create_info) {
+  return m_state_interner.GetOrCreate<RasterizerStateBase>(create_info, [this](const MGPURasterizerStateCreateInfo& create_info) {
+    return CreateRasterizerStateImpl(create_info);
+  });
+}
+
+Result<InputAssemblyStateBase*> DeviceBase::CreateInputAssemblyState(const MGPUInputAssemblyStateCreateInfo& create_info) {
+  return m_state_interner.GetOrCreate<InputAssemblyStateBase>(create_info, [this](const MGPUInputAssemblyStateCreateInfo& create_info) {
+    return CreateInputAssemblyStateImpl(create_info);
+  });
+}
+
+Result<ColorBlendStateBase*> DeviceBase::CreateColorBlendState(const MGPUColorBlendStateCreateInfo& create_info) {
+  return m_state_interner.GetOrCreate<ColorBlendStateBase>(create_info, [this](const MGPUColorBlendStateCreateInfo& create_info) {
+    return CreateColorBlendStateImpl(create_info);
+  });
+}
+
+Result<VertexInputStateBase*> DeviceBase::CreateVertexInputState(const MGPUVertexInputStateCreateInfo& create_info) {
+  return m_state_interner.GetOrCreate<VertexInputStateBase>(create_info, [this](const MGPUVertexInputStateCreateInfo& create_info) {
+    return CreateVertexInputStateImpl(create_info);
+  });
+}
+
+Result<DepthStencilStateBase*> DeviceBase::CreateDepthStencilState(const MGPUDepthStencilStateCreateInfo& create_info) {
+  return m_state_interner.GetOrCreate<DepthStencilStateBase>(create_info, [this](const MGPUDepthStencilStateCreateInfo& create_info) {
+    return CreateDepthStencilStateImpl(create_info);
+  });
+}
+
 RasterizerStateBase* DeviceBase::GetDefaultRasterizerState() {
+  std::lock_guard lock_guard{m_default_state_mutex};
+
   if(m_default_rasterizer_state == nullptr) {
     m_default_rasterizer_state = CreateRasterizerState({
       .depth_clamp_enable = false,
@@ -24,6 +62,8 @@ RasterizerStateBase* DeviceBase::GetDefaultRasterizerState() {
 }
 
 InputAssemblyStateBase* DeviceBase::GetDefaultInputAssemblyState() {
+  std::lock_guard lock_guard{m_default_state_mutex};
+
   if(m_default_input_assembly_state == nullptr) {
     m_default_input_assembly_state = CreateInputAssemblyState({
       .topology = MGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
@@ -34,6 +74,8 @@ InputAssemblyStateBase* DeviceBase::GetDefaultInputAssemblyState() {
 }
 
 VertexInputStateBase* DeviceBase::GetDefaultVertexInputState() {
+  std::lock_guard lock_guard{m_default_state_mutex};
+
   if(m_default_vertex_input_state == nullptr) {
     m_default_vertex_input_state = CreateVertexInputState({
       .binding_count = 0u,
@@ -46,6 +88,8 @@ VertexInputStateBase* DeviceBase::GetDefaultVertexInputState() {
 }
 
 DepthStencilStateBase* DeviceBase::GetDefaultDepthStencilState() {
+  std::lock_guard lock_guard{m_default_state_mutex};
+
   if(m_default_depth_stencil_state == nullptr) {
     m_default_depth_stencil_state = CreateDepthStencilState({
       .depth_test_enable = false,
@@ -60,6 +104,8 @@ DepthStencilStateBase* DeviceBase::GetDefaultDepthStencilState() {
 }
 
 ColorBlendStateBase* DeviceBase::GetDefaultColorBlendState(u32 attachment_count) {
+  std::lock_guard lock_guard{m_default_state_mutex};
+
   auto& default_color_blend_state = m_default_color_blend_states[attachment_count];
   if(default_color_blend_state == nullptr) {
     atom::Vector_N<MGPUColorBlendAttachmentState, limits::max_color_attachments> attachment_blend_states{};
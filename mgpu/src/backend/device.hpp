@@ -5,7 +5,11 @@
 #include <atom/integer.hpp>
 #include <atom/non_copyable.hpp>
 #include <atom/non_moveable.hpp>
+#include <mutex>
+#include <span>
+#include <vector>
 
+#include "backend/pipeline_state/state_interner.hpp"
 #include "common/limits.hpp"
 #include "common/result.hpp"
 
@@ -25,6 +29,8 @@ class ColorBlendStateBase;
 class VertexInputStateBase;
 class DepthStencilStateBase;
 class SwapChainBase;
+class CommandBundleBase;
+class CommandList;
 
 class DeviceBase : atom::NonCopyable, atom::NonMoveable {
   public:
@@ -42,12 +48,17 @@ class DeviceBase : atom::NonCopyable, atom::NonMoveable {
     virtual Result<ResourceSetBase*> CreateResourceSet(const MGPUResourceSetCreateInfo& create_info) = 0;
     virtual Result<ShaderModuleBase*> CreateShaderModule(const u32* spirv_code, size_t spirv_byte_size) = 0;
     virtual Result<ShaderProgramBase*> CreateShaderProgram(const MGPUShaderProgramCreateInfo& create_info) = 0;
-    virtual Result<RasterizerStateBase*> CreateRasterizerState(const MGPURasterizerStateCreateInfo& create_info) = 0;
-    virtual Result<InputAssemblyStateBase*> CreateInputAssemblyState(const MGPUInputAssemblyStateCreateInfo& create_info) = 0;
-    virtual Result<ColorBlendStateBase*> CreateColorBlendState(const MGPUColorBlendStateCreateInfo& create_info) = 0;
-    virtual Result<VertexInputStateBase*> CreateVertexInputState(const MGPUVertexInputStateCreateInfo& create_info) = 0;
-    virtual Result<DepthStencilStateBase*> CreateDepthStencilState(const MGPUDepthStencilStateCreateInfo& create_info) = 0;
+    Result<RasterizerStateBase*> CreateRasterizerState(const MGPURasterizerStateCreateInfo& create_info);
+    Result<InputAssemblyStateBase*> CreateInputAssemblyState(const MGPUInputAssemblyStateCreateInfo& create_info);
+    Result<ColorBlendStateBase*> CreateColorBlendState(const MGPUColorBlendStateCreateInfo& create_info);
+    Result<VertexInputStateBase*> CreateVertexInputState(const MGPUVertexInputStateCreateInfo& create_info);
+    Result<DepthStencilStateBase*> CreateDepthStencilState(const MGPUDepthStencilStateCreateInfo& create_info);
     virtual Result<SwapChainBase*> CreateSwapChain(const MGPUSwapChainCreateInfo& create_info) = 0;
+    virtual Result<CommandBundleBase*> CreateCommandBundle(const CommandList* command_list) = 0;
+    virtual Result<std::vector<u8>> GetPipelineCacheData() = 0;
+    virtual void SetFallbackShaderProgram(ShaderProgramBase* shader_program) = 0;
+    [[nodiscard]] virtual u32 GetPendingPipelineCompilationCount() const = 0;
+    virtual MGPUResult PrecompileGraphicsPipelines(std::span<const MGPUGraphicsPipelineInfo> pipeline_infos) = 0;
 
     [[nodiscard]] RasterizerStateBase* GetDefaultRasterizerState();
     [[nodiscard]] InputAssemblyStateBase* GetDefaultInputAssemblyState();
@@ -55,8 +66,21 @@ class DeviceBase : atom::NonCopyable, atom::NonMoveable {
     [[nodiscard]] DepthStencilStateBase* GetDefaultDepthStencilState();
     [[nodiscard]] ColorBlendStateBase* GetDefaultColorBlendState(u32 attachment_count);
 
+  protected:
+    // Called by the Create*State() methods, when no state with identical contents exists yet.
+    virtual Result<RasterizerStateBase*> CreateRasterizerStateImpl(const MGPURasterizerStateCreateInfo& create_info) = 0;
+    virtual Result<InputAssemblyStateBase*> CreateInputAssemblyStateImpl(const MGPUInputAssemblyStateCreateInfo& create_info) = 0;
+    virtual Result<ColorBlendStateBase*> CreateColorBlendStateImpl(const MGPUColorBlendStateCreateInfo& create_info) = 0;
+    virtual Result<VertexInputStateBase*> CreateVertexInputStateImpl(const MGPUVertexInputStateCreateInfo& create_info) = 0;
+    virtual Result<DepthStencilStateBase*> CreateDepthStencilStateImpl(const MGPUDepthStencilStateCreateInfo& create_info) = 0;
+
   private:
     MGPUPhysicalDeviceLimits m_limits{};
+
+    StateInterner m_state_interner{};
+
+    // Command lists may be recorded on multiple threads at once, which all may request the default states.
+    std::mutex m_default_state_mutex{};
     RasterizerStateBase* m_default_rasterizer_state{};
     InputAssemblyStateBase* m_default_input_assembly_state{};
     VertexInputStateBase* m_default_vertex_input_state{};
@@ -0,0 +1,41 @@
+
+#include <new>
+
+#include "buffer.hpp"
+
+namespace mgpu::null {
+
+Buffer::Buffer(std::unique_ptr<u8[]> data, const MGPUBufferCreateInfo& create_info)
+    : BufferBase{create_info}
+    , m_data{std::move(data)} {
+}
+
+Result<BufferBase*> Buffer::Create(const MGPUBufferCreateInfo& create_info) {
+  std::unique_ptr<u8[]> data{new(std::nothrow) u8[create_info.size]};
+  if(data == nullptr) {
+    return MGPU_OUT_OF_MEMORY;
+  }
+  return new Buffer{std::move(data), create_info};
+}
+
+bool Buffer::IsMapped() const {
+  return m_mapped;
+}
+
+Result<void*> Buffer::Map() {
+  m_mapped = true;
+  return (void*)m_data.get();
+}
+
+MGPUResult Buffer::Unmap() {
+  m_mapped = false;
+  return MGPU_SUCCESS;
+}
+
+MGPUResult Buffer::FlushRange(u64 offset, u64 size) {
+  (void)offset;
+  (void)size;
+  return MGPU_SUCCESS;
+}
+
+}  // namespace mgpu::null
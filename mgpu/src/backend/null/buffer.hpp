@@ -0,0 +1,32 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
+#include <memory>
+
+#include "backend/buffer.hpp"
+#include "common/result.hpp"
+
+namespace mgpu::null {
+
+class Buffer final : public BufferBase {
+  public:
+    static Result<BufferBase*> Create(const MGPUBufferCreateInfo& create_info);
+
+    [[nodiscard]] u8* Data() { return m_data.get(); }
+
+    [[nodiscard]] bool IsMapped() const override;
+
+    Result<void*> Map() override;
+    MGPUResult Unmap() override;
+    MGPUResult FlushRange(u64 offset, u64 size) override;
+
+  private:
+    Buffer(std::unique_ptr<u8[]> data, const MGPUBufferCreateInfo& create_info);
+
+    std::unique_ptr<u8[]> m_data;
+    bool m_mapped{false};
+};
+
+}  // namespace mgpu::null
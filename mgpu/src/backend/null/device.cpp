@@ -0,0 +1,121 @@
+
+#include "backend/pipeline_state/color_blend_state.hpp"
+#include "backend/pipeline_state/depth_stencil_state.hpp"
+#include "backend/pipeline_state/input_assembly_state.hpp"
+#include "backend/pipeline_state/rasterizer_state.hpp"
+#include "backend/pipeline_state/shader_module.hpp"
+#include "backend/pipeline_state/shader_program.hpp"
+#include "backend/pipeline_state/vertex_input_state.hpp"
+#include "backend/command_bundle.hpp"
+#include "backend/resource_set_layout.hpp"
+#include "backend/resource_set.hpp"
+#include "backend/sampler.hpp"
+#include "buffer.hpp"
+#include "device.hpp"
+#include "swap_chain.hpp"
+#include "texture.hpp"
+
+namespace mgpu::null {
+
+// The null backend does not translate any state into backend specific objects,
+// so objects which carry no host-side data are represented by their base classes directly.
+
+Device::Device(const MGPUPhysicalDeviceLimits& limits) : DeviceBase{limits} {
+}
+
+Result<DeviceBase*> Device::Create(const MGPUPhysicalDeviceLimits& limits) {
+  return new Device{limits};
+}
+
+QueueBase* Device::GetQueue(MGPUQueueType queue_type) {
+  switch(queue_type) {
+    case MGPU_QUEUE_TYPE_GRAPHICS_COMPUTE:
+    case MGPU_QUEUE_TYPE_ASYNC_COMPUTE: return &m_queue;
+  }
+  return nullptr;
+}
+
+Result<BufferBase*> Device::CreateBuffer(const MGPUBufferCreateInfo& create_info) {
+  return Buffer::Create(create_info);
+}
+
+Result<TextureBase*> Device::CreateTexture(const MGPUTextureCreateInfo& create_info) {
+  return Texture::Create(create_info);
+}
+
+Result<SamplerBase*> Device::CreateSampler(const MGPUSamplerCreateInfo& create_info) {
+  (void)create_info;
+  return new SamplerBase{};
+}
+
+Result<ResourceSetLayoutBase*> Device::CreateResourceSetLayout(const MGPUResourceSetLayoutCreateInfo& create_info) {
+  return new ResourceSetLayoutBase{create_info};
+}
+
+Result<ResourceSetBase*> Device::CreateResourceSet(const MGPUResourceSetCreateInfo& create_info) {
+  return new ResourceSetBase{create_info};
+}
+
+Result<ShaderModuleBase*> Device::CreateShaderModule(const u32* spirv_code, size_t spirv_byte_size) {
+  (void)spirv_code;
+  (void)spirv_byte_size;
+  return new ShaderModuleBase{};
+}
+
+Result<ShaderProgramBase*> Device::CreateShaderProgram(const MGPUShaderProgramCreateInfo& create_info) {
+  return new ShaderProgramBase{create_info};
+}
+
+Result<RasterizerStateBase*> Device::CreateRasterizerStateImpl(const MGPURasterizerStateCreateInfo& create_info) {
+  (void)create_info;
+  return new RasterizerStateBase{};
+}
+
+Result<InputAssemblyStateBase*> Device::CreateInputAssemblyStateImpl(const MGPUInputAssemblyStateCreateInfo& create_info) {
+  (void)create_info;
+  return new InputAssemblyStateBase{};
+}
+
+Result<ColorBlendStateBase*> Device::CreateColorBlendStateImpl(const MGPUColorBlendStateCreateInfo& create_info) {
+  (void)create_info;
+  return new ColorBlendStateBase{};
+}
+
+Result<VertexInputStateBase*> Device::CreateVertexInputStateImpl(const MGPUVertexInputStateCreateInfo& create_info) {
+  (void)create_info;
+  return new VertexInputStateBase{};
+}
+
+Result<DepthStencilStateBase*> Device::CreateDepthStencilStateImpl(const MGPUDepthStencilStateCreateInfo& create_info) {
+  (void)create_info;
+  return new DepthStencilStateBase{};
+}
+
+Result<SwapChainBase*> Device::CreateSwapChain(const MGPUSwapChainCreateInfo& create_info) {
+  return SwapChain::Create(create_info);
+}
+
+Result<CommandBundleBase*> Device::CreateCommandBundle(const CommandList* command_list) {
+  // There is nothing to translate the commands to, so executing the bundle is a no-op.
+  return new CommandBundleBase{*command_list};
+}
+
+Result<std::vector<u8>> Device::GetPipelineCacheData() {
+  return std::vector<u8>{};
+}
+
+void Device::SetFallbackShaderProgram(ShaderProgramBase* shader_program) {
+  // Draws are never skipped, so a fallback is never needed.
+  (void)shader_program;
+}
+
+u32 Device::GetPendingPipelineCompilationCount() const {
+  return 0u;
+}
+
+MGPUResult Device::PrecompileGraphicsPipelines(std::span<const MGPUGraphicsPipelineInfo> pipeline_infos) {
+  (void)pipeline_infos;
+  return MGPU_SUCCESS;
+}
+
+}  // namespace mgpu::null
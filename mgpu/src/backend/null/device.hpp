@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include <memory>
+
+#include "backend/device.hpp"
+#include "common/result.hpp"
+#include "queue.hpp"
+
+namespace mgpu::null {
+
+class Device final : public DeviceBase {
+  public:
+    static Result<DeviceBase*> Create(const MGPUPhysicalDeviceLimits& limits);
+
+    QueueBase* GetQueue(MGPUQueueType queue_type) override;
+    Result<BufferBase*> CreateBuffer(const MGPUBufferCreateInfo& create_info) override;
+    Result<TextureBase*> CreateTexture(const MGPUTextureCreateInfo& create_info) override;
+    Result<SamplerBase*> CreateSampler(const MGPUSamplerCreateInfo& create_info) override;
+    Result<ResourceSetLayoutBase*> CreateResourceSetLayout(const MGPUResourceSetLayoutCreateInfo& create_info) override;
+    Result<ResourceSetBase*> CreateResourceSet(const MGPUResourceSetCreateInfo& create_info) override;
+    Result<ShaderModuleBase*> CreateShaderModule(const u32* spirv_code, size_t spirv_byte_size) override;
+    Result<ShaderProgramBase*> CreateShaderProgram(const MGPUShaderProgramCreateInfo& create_info) override;
+    Result<SwapChainBase*> CreateSwapChain(const MGPUSwapChainCreateInfo& create_info) override;
+    Result<CommandBundleBase*> CreateCommandBundle(const CommandList* command_list) override;
+    Result<std::vector<u8>> GetPipelineCacheData() override;
+    void SetFallbackShaderProgram(ShaderProgramBase* shader_program) override;
+    [[nodiscard]] u32 GetPendingPipelineCompilationCount() const override;
+    MGPUResult PrecompileGraphicsPipelines(std::span<const MGPUGraphicsPipelineInfo> pipeline_infos) override;
+
+  protected:
+    Result<RasterizerStateBase*> CreateRasterizerStateImpl(const MGPURasterizerStateCreateInfo& create_info) override;
+    Result<InputAssemblyStateBase*> CreateInputAssemblyStateImpl(const MGPUInputAssemblyStateCreateInfo& create_info) override;
+    Result<ColorBlendStateBase*> CreateColorBlendStateImpl(const MGPUColorBlendStateCreateInfo& create_info) override;
+    Result<VertexInputStateBase*> CreateVertexInputStateImpl(const MGPUVertexInputStateCreateInfo& create_info) override;
+    Result<DepthStencilStateBase*> CreateDepthStencilStateImpl(const MGPUDepthStencilStateCreateInfo& create_info) override;
+
+  private:
+    explicit Device(const MGPUPhysicalDeviceLimits& limits);
+
+    // The null device only exposes a single queue, which is used for both graphics and async compute work.
+    Queue m_queue{};
+};
+
+}  // namespace mgpu::null
@@ -0,0 +1,25 @@
+
+#include "instance.hpp"
+
+namespace mgpu::null {
+
+Instance::~Instance() {
+  delete m_physical_device;
+}
+
+Result<InstanceBase*> Instance::Create() {
+  return new Instance{};
+}
+
+Result<std::span<PhysicalDeviceBase* const>> Instance::EnumeratePhysicalDevices() {
+  return std::span<PhysicalDeviceBase* const>{&m_physical_device, 1u};
+}
+
+Result<SurfaceBase*> Instance::CreateSurface(const MGPUSurfaceCreateInfo& create_info) {
+  (void)create_info;
+
+  // There is no window system to present to, so the native window handles are ignored.
+  return new SurfaceBase{};
+}
+
+}  // namespace mgpu::null
@@ -0,0 +1,27 @@
+
+#pragma once
+
+#include <memory>
+
+#include "backend/instance.hpp"
+#include "common/result.hpp"
+#include "physical_device.hpp"
+
+namespace mgpu::null {
+
+class Instance final : public InstanceBase {
+  public:
+   ~Instance() override;
+
+    static Result<InstanceBase*> Create();
+
+    Result<std::span<PhysicalDeviceBase* const>> EnumeratePhysicalDevices() override;
+    Result<SurfaceBase*> CreateSurface(const MGPUSurfaceCreateInfo& create_info) override;
+
+  private:
+    Instance() = default;
+
+    PhysicalDeviceBase* m_physical_device{new PhysicalDevice{}};
+};
+
+}  // namespace mgpu::null
@@ -0,0 +1,95 @@
+
+#include <atom/integer.hpp>
+#include <cstring>
+#include <limits>
+
+#include "common/limits.hpp"
+#include "device.hpp"
+#include "physical_device.hpp"
+
+namespace mgpu::null {
+
+PhysicalDevice::PhysicalDevice() : PhysicalDeviceBase{GetInfo()} {
+}
+
+Result<MGPUSurfaceCapabilities> PhysicalDevice::GetSurfaceCapabilities(mgpu::SurfaceBase* surface) {
+  (void)surface;
+
+  const u32 max_extent = Limits().max_attachment_dimension;
+
+  return MGPUSurfaceCapabilities{
+    .min_texture_count = 1u,
+    .max_texture_count = std::numeric_limits<u32>::max(),
+    .current_extent = {
+      .width = max_extent,
+      .height = max_extent
+    },
+    .min_texture_extent = {
+      .width = 1u,
+      .height = 1u
+    },
+    .max_texture_extent = {
+      .width = max_extent,
+      .height = max_extent
+    },
+    .supported_usage = MGPU_TEXTURE_USAGE_COPY_SRC | MGPU_TEXTURE_USAGE_COPY_DST | MGPU_TEXTURE_USAGE_SAMPLED |
+                       MGPU_TEXTURE_USAGE_STORAGE | MGPU_TEXTURE_USAGE_RENDER_ATTACHMENT
+  };
+}
+
+Result<std::vector<MGPUSurfaceFormat>> PhysicalDevice::EnumerateSurfaceFormats(mgpu::SurfaceBase* surface) {
+  (void)surface;
+  return std::vector<MGPUSurfaceFormat>{{MGPU_TEXTURE_FORMAT_B8G8R8A8_SRGB, MGPU_COLOR_SPACE_SRGB_NONLINEAR}};
+}
+
+Result<std::vector<MGPUPresentMode>> PhysicalDevice::EnumerateSurfacePresentModes(mgpu::SurfaceBase* surface) {
+  (void)surface;
+  return std::vector<MGPUPresentMode>{
+    MGPU_PRESENT_MODE_IMMEDIATE,
+    MGPU_PRESENT_MODE_MAILBOX,
+    MGPU_PRESENT_MODE_FIFO,
+    MGPU_PRESENT_MODE_FIFO_RELAXED
+  };
+}
+
+Result<DeviceBase*> PhysicalDevice::CreateDevice(const MGPUDeviceCreateInfo& create_info) {
+  // The null backend does not compile any pipelines, so there is nothing to cache.
+  (void)create_info;
+  return Device::Create(Limits());
+}
+
+MGPUPhysicalDeviceInfo PhysicalDevice::GetInfo() {
+  MGPUPhysicalDeviceInfo mgpu_device_info{};
+
+  std::strcpy(mgpu_device_info.device_name, "mgpu null device");
+  mgpu_device_info.device_type = MGPU_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU;
+
+  // Limits roughly match those guaranteed by Vulkan on desktop class hardware,
+  // so that applications behave the same way as they would on a real device.
+  MGPUPhysicalDeviceLimits& mgpu_device_limits = mgpu_device_info.limits;
+  mgpu_device_limits.max_texture_dimension_1d = 16384u;
+  mgpu_device_limits.max_texture_dimension_2d = 16384u;
+  mgpu_device_limits.max_texture_dimension_3d = 2048u;
+  mgpu_device_limits.max_texture_array_layers = 2048u;
+  mgpu_device_limits.max_sampler_allocation_count = 4000u;
+  mgpu_device_limits.max_sampler_lod_bias = 15.0f;
+  mgpu_device_limits.max_sampler_anisotropy = 16.0f;
+  mgpu_device_limits.max_color_attachments = limits::max_color_attachments;
+  mgpu_device_limits.max_attachment_dimension = 16384u;
+  mgpu_device_limits.max_vertex_input_bindings = limits::max_vertex_input_bindings;
+  mgpu_device_limits.max_vertex_input_attributes = limits::max_vertex_input_attributes;
+  mgpu_device_limits.max_vertex_input_binding_stride = 2048u;
+  mgpu_device_limits.max_vertex_input_attribute_offset = 2047u;
+  mgpu_device_limits.max_draw_indirect_count = 0xFFFFFFFFu;
+  mgpu_device_limits.draw_indirect_count = true;
+  mgpu_device_limits.max_push_constants_size = limits::max_push_constants_size;
+  for(u32& max_compute_work_group_count : mgpu_device_limits.max_compute_work_group_count) {
+    max_compute_work_group_count = 65535u;
+  }
+  mgpu_device_limits.min_uniform_buffer_offset_alignment = 256u;
+  mgpu_device_limits.min_storage_buffer_offset_alignment = 256u;
+
+  return mgpu_device_info;
+}
+
+}  // namespace mgpu::null
@@ -0,0 +1,23 @@
+
+#pragma once
+
+#include <vector>
+
+#include "backend/physical_device.hpp"
+
+namespace mgpu::null {
+
+class PhysicalDevice final : public PhysicalDeviceBase {
+  public:
+    PhysicalDevice();
+
+    Result<MGPUSurfaceCapabilities> GetSurfaceCapabilities(mgpu::SurfaceBase* surface) override;
+    Result<std::vector<MGPUSurfaceFormat>> EnumerateSurfaceFormats(mgpu::SurfaceBase* surface) override;
+    Result<std::vector<MGPUPresentMode>> EnumerateSurfacePresentModes(mgpu::SurfaceBase* surface) override;
+    Result<DeviceBase*> CreateDevice(const MGPUDeviceCreateInfo& create_info) override;
+
+  private:
+    static MGPUPhysicalDeviceInfo GetInfo();
+};
+
+}  // namespace mgpu::null
@@ -0,0 +1,108 @@
+
+#include <atom/panic.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "buffer.hpp"
+#include "queue.hpp"
+
+namespace mgpu::null {
+
+MGPUResult Queue::SubmitCommandList(const CommandList* command_list) {
+  // Decode the command list like a real backend would, but do not translate any of the commands.
+  // This allows for measuring the CPU overhead of recording and submission in isolation.
+  for(const CommandBase& command : *command_list) {
+    const CommandType command_type = command.m_command_type;
+
+    switch(command_type) {
+      case CommandType::BeginRenderPass:
+      case CommandType::EndRenderPass:
+      case CommandType::UseShaderProgram:
+      case CommandType::UseRasterizerState:
+      case CommandType::UseInputAssemblyState:
+      case CommandType::UseColorBlendState:
+      case CommandType::UseVertexInputState:
+      case CommandType::UseDepthStencilState:
+      case CommandType::SetViewport:
+      case CommandType::SetScissor:
+      case CommandType::BindVertexBuffer:
+      case CommandType::BindIndexBuffer:
+      case CommandType::BindResourceSet:
+      case CommandType::PushConstants:
+      case CommandType::Draw:
+      case CommandType::DrawIndexed:
+      case CommandType::DrawIndirect:
+      case CommandType::DrawIndexedIndirect:
+      case CommandType::ExecuteCommandBundle:
+      case CommandType::BeginComputePass:
+      case CommandType::EndComputePass:
+      case CommandType::Dispatch:
+      case CommandType::DispatchIndirect: break;
+      case CommandType::AppendCommandList: {
+        SubmitCommandList(((const AppendCommandListCommand&)command).m_command_list);
+        break;
+      }
+      default: {
+        ATOM_PANIC("mgpu: null: unhandled command type: {}", (int)command_type);
+      }
+    }
+  }
+
+  return MGPU_SUCCESS;
+}
+
+MGPUResult Queue::BufferUpload(const BufferBase* buffer, std::span<const u8> data, u64 offset) {
+  std::memcpy(((Buffer*)buffer)->Data() + offset, data.data(), data.size_bytes());
+  return MGPU_SUCCESS;
+}
+
+MGPUResult Queue::TextureUpload(const TextureBase* texture, const MGPUTextureUploadRegion& region, const void* data) {
+  // Texture contents can never be observed by the application, so there is no need to keep them around.
+  (void)texture;
+  (void)region;
+  (void)data;
+  return MGPU_SUCCESS;
+}
+
+Result<QueueBase::TransientAllocation> Queue::AllocateTransient(u64 size, u64 alignment, MGPUBufferUsage usage) {
+  if(usage & (MGPU_BUFFER_USAGE_UNIFORM_BUFFER | MGPU_BUFFER_USAGE_STORAGE_BUFFER)) {
+    alignment = std::max(alignment, k_min_buffer_offset_alignment);
+  }
+
+  u64 offset = (m_transient_buffer_offset + alignment - 1u) & ~(alignment - 1u);
+
+  if(m_transient_buffer == nullptr || offset + size > m_transient_buffer->Size()) {
+    const u64 old_size = m_transient_buffer ? m_transient_buffer->Size() : 0u;
+
+    Result<BufferBase*> buffer_result = Buffer::Create({
+      .size = std::max({k_initial_transient_buffer_size, old_size * 2u, std::bit_ceil(size)}),
+      .usage = k_transient_buffer_usage,
+      .flags = MGPU_BUFFER_FLAGS_HOST_VISIBLE
+    });
+    MGPU_FORWARD_ERROR(buffer_result.Code());
+
+    if(m_transient_buffer != nullptr) {
+      m_retired_transient_buffers.push_back(std::move(m_transient_buffer));
+    }
+    m_transient_buffer.reset((Buffer*)buffer_result.Unwrap());
+    offset = 0u;
+  }
+
+  m_transient_buffer_offset = offset + size;
+  return TransientAllocation{m_transient_buffer.get(), offset, m_transient_buffer->Data() + offset};
+}
+
+Result<ResourceSetBase*> Queue::CreateTransientResourceSet(const MGPUResourceSetCreateInfo& create_info) {
+  return m_transient_resource_sets.emplace_back(std::make_unique<ResourceSetBase>(create_info)).get();
+}
+
+MGPUResult Queue::Flush() {
+  // Nothing is ever executed, so all transient memory and resource sets can be released immediately.
+  m_retired_transient_buffers.clear();
+  m_transient_buffer_offset = 0u;
+  m_transient_resource_sets.clear();
+  return MGPU_SUCCESS;
+}
+
+}  // namespace mgpu::null
@@ -0,0 +1,39 @@
+
+#pragma once
+
+#include <atom/integer.hpp>
+#include <memory>
+#include <vector>
+
+#include "backend/command_list/command_list.hpp"
+#include "backend/queue.hpp"
+#include "backend/resource_set.hpp"
+#include "buffer.hpp"
+
+namespace mgpu::null {
+
+class Queue final : public QueueBase {
+  public:
+    MGPUResult SubmitCommandList(const CommandList* command_list) override;
+    MGPUResult BufferUpload(const BufferBase* buffer, std::span<const u8> data, u64 offset) override;
+    MGPUResult TextureUpload(const TextureBase* texture, const MGPUTextureUploadRegion& region, const void* data) override;
+    Result<TransientAllocation> AllocateTransient(u64 size, u64 alignment, MGPUBufferUsage usage) override;
+    Result<ResourceSetBase*> CreateTransientResourceSet(const MGPUResourceSetCreateInfo& create_info) override;
+    MGPUResult Flush() override;
+
+  private:
+    static constexpr u64 k_initial_transient_buffer_size = 4u * 1024u * 1024u;
+
+    // Matches the uniform and storage buffer offset alignments reported by the null physical device.
+    static constexpr u64 k_min_buffer_offset_alignment = 256u;
+
+    std::unique_ptr<Buffer> m_transient_buffer{};
+    u64 m_transient_buffer_offset{};
+
+    // Buffers which ran out of space, but may still be referenced by command lists which are submitted before the next flush.
+    std::vector<std::unique_ptr<Buffer>> m_retired_transient_buffers{};
+
+    std::vector<std::unique_ptr<ResourceSetBase>> m_transient_resource_sets{};
+};
+
+}  // namespace mgpu::null
@@ -0,0 +1,53 @@
+
+#include <algorithm>
+
+#include "swap_chain.hpp"
+#include "texture.hpp"
+
+namespace mgpu::null {
+
+SwapChain::SwapChain(std::vector<TextureBase*> textures) : m_textures{std::move(textures)} {
+}
+
+SwapChain::~SwapChain() {
+  for(auto texture : m_textures) delete texture;
+}
+
+Result<SwapChainBase*> SwapChain::Create(const MGPUSwapChainCreateInfo& create_info) {
+  const MGPUTextureCreateInfo texture_info{
+    .format = create_info.format,
+    .type = MGPU_TEXTURE_TYPE_2D,
+    .extent = {
+      .width = create_info.extent.width,
+      .height = create_info.extent.height,
+      .depth = 1u
+    },
+    .mip_count = 1u,
+    .array_layer_count = 1u,
+    .usage = create_info.usage
+  };
+
+  std::vector<TextureBase*> textures{};
+
+  for(u32 i = 0; i < std::max(create_info.min_texture_count, 1u); i++) {
+    textures.push_back(Texture::Create(texture_info).Unwrap());
+  }
+
+  return new SwapChain{std::move(textures)};
+}
+
+Result<std::span<TextureBase* const>> SwapChain::EnumerateTextures() {
+  return std::span<TextureBase* const>{m_textures};
+}
+
+MGPUResult SwapChain::AcquireNextTexture(u32& acquired_texture_index) {
+  acquired_texture_index = m_next_texture_index;
+  m_next_texture_index = (m_next_texture_index + 1u) % (u32)m_textures.size();
+  return MGPU_SUCCESS;
+}
+
+MGPUResult SwapChain::Present() {
+  return MGPU_SUCCESS;
+}
+
+}  // namespace mgpu::null
@@ -0,0 +1,29 @@
+
+#pragma once
+
+#include <atom/integer.hpp>
+#include <vector>
+
+#include "backend/swap_chain.hpp"
+#include "common/result.hpp"
+
+namespace mgpu::null {
+
+class SwapChain final : public SwapChainBase {
+  public:
+   ~SwapChain() override;
+
+    static Result<SwapChainBase*> Create(const MGPUSwapChainCreateInfo& create_info);
+
+    Result<std::span<TextureBase* const>> EnumerateTextures() override;
+    MGPUResult AcquireNextTexture(u32& acquired_texture_index) override;
+    MGPUResult Present() override;
+
+  private:
+    explicit SwapChain(std::vector<TextureBase*> textures);
+
+    std::vector<TextureBase*> m_textures{};
+    u32 m_next_texture_index{};
+};
+
+}  // namespace mgpu::null
@@ -0,0 +1,18 @@
+
+#include "texture.hpp"
+#include "texture_view.hpp"
+
+namespace mgpu::null {
+
+Texture::Texture(const MGPUTextureCreateInfo& create_info) : TextureBase{create_info} {
+}
+
+Result<TextureBase*> Texture::Create(const MGPUTextureCreateInfo& create_info) {
+  return new Texture{create_info};
+}
+
+Result<TextureViewBase*> Texture::CreateView(const MGPUTextureViewCreateInfo& create_info) {
+  return TextureView::Create(this, create_info);
+}
+
+}  // namespace mgpu::null
@@ -0,0 +1,21 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+
+#include "backend/texture.hpp"
+#include "common/result.hpp"
+
+namespace mgpu::null {
+
+class Texture final : public TextureBase {
+  public:
+    static Result<TextureBase*> Create(const MGPUTextureCreateInfo& create_info);
+
+    Result<TextureViewBase*> CreateView(const MGPUTextureViewCreateInfo& create_info) override;
+
+  private:
+    explicit Texture(const MGPUTextureCreateInfo& create_info);
+};
+
+}  // namespace mgpu::null
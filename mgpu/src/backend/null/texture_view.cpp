@@ -0,0 +1,15 @@
+
+#include "texture_view.hpp"
+
+namespace mgpu::null {
+
+TextureView::TextureView(Texture* texture, const MGPUTextureViewCreateInfo& create_info)
+    : TextureViewBase{create_info}
+    , m_texture{texture} {
+}
+
+Result<TextureViewBase*> TextureView::Create(Texture* texture, const MGPUTextureViewCreateInfo& create_info) {
+  return new TextureView{texture, create_info};
+}
+
+}  // namespace mgpu::null
@@ -0,0 +1,22 @@
+
+#pragma once
+
+#include "backend/texture_view.hpp"
+#include "common/result.hpp"
+#include "texture.hpp"
+
+namespace mgpu::null {
+
+class TextureView final : public TextureViewBase {
+  public:
+    static Result<TextureViewBase*> Create(Texture* texture, const MGPUTextureViewCreateInfo& create_info);
+
+    Texture* GetTexture() override { return m_texture; }
+
+  private:
+    TextureView(Texture* texture, const MGPUTextureViewCreateInfo& create_info);
+
+    Texture* m_texture{};
+};
+
+}  // namespace mgpu::null
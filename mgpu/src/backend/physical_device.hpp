@@ -25,7 +25,7 @@ class PhysicalDeviceBase : atom::NonCopyable, atom::NonMoveable {
     virtual Result<MGPUSurfaceCapabilities> GetSurfaceCapabilities(mgpu::SurfaceBase* surface) = 0;
     virtual Result<std::vector<MGPUSurfaceFormat>> EnumerateSurfaceFormats(mgpu::SurfaceBase* surface) = 0;
     virtual Result<std::vector<MGPUPresentMode>> EnumerateSurfacePresentModes(mgpu::SurfaceBase* surface) = 0;
-    virtual Result<DeviceBase*> CreateDevice() = 0;
+    virtual Result<DeviceBase*> CreateDevice(const MGPUDeviceCreateInfo& create_info) = 0;
 
   private:
     MGPUPhysicalDeviceInfo m_info{};
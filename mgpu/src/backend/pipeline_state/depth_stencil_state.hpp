@@ -1,14 +1,10 @@
 
 #pragma once
 
-#include <atom/non_copyable.hpp>
-#include <atom/non_moveable.hpp>
+#include "state_interner.hpp"
 
 namespace mgpu {
 
-class DepthStencilStateBase : atom::NonCopyable, atom::NonMoveable {
-  public:
-    virtual ~DepthStencilStateBase() = default;
-};
+class DepthStencilStateBase : public InternedStateBase {};
 
 } // namespace mgpu
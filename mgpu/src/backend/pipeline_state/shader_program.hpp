@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
+#include <vector>
+
 #include "atom/non_copyable.hpp"
 #include "atom/non_moveable.hpp"
 
@@ -8,7 +12,45 @@ namespace mgpu {
 
 class ShaderProgramBase : atom::NonCopyable, atom::NonMoveable {
   public:
+    explicit ShaderProgramBase(const MGPUShaderProgramCreateInfo& create_info)
+        : m_push_constant_ranges{create_info.push_constant_ranges, create_info.push_constant_ranges + create_info.push_constant_range_count} {
+      for(size_t i = 0u; i < create_info.shader_stage_count; i++) {
+        m_stages |= create_info.shader_stages[i].stage;
+      }
+    }
+
     virtual ~ShaderProgramBase() = default;
+
+    [[nodiscard]] MGPUShaderStage GetStages() const { return m_stages; }
+
+    /**
+     * Returns the shader stages which a push of the given byte range updates.
+     * Every byte in the range must be visible to the same set of stages. Otherwise, or if the range is not covered
+     * by any push constant range of the shader program, zero is returned.
+     */
+    [[nodiscard]] MGPUShaderStage GetPushConstantStages(u32 offset, u32 size) const {
+      MGPUShaderStage stages = 0;
+
+      for(u32 address = offset; address < offset + size; address += sizeof(u32)) {
+        MGPUShaderStage address_stages = 0;
+        for(const MGPUPushConstantRange& range : m_push_constant_ranges) {
+          if(address >= range.offset && address < range.offset + range.size) {
+            address_stages |= range.stages;
+          }
+        }
+
+        if(address_stages == 0 || (address != offset && address_stages != stages)) {
+          return 0;
+        }
+        stages = address_stages;
+      }
+
+      return stages;
+    }
+
+  private:
+    MGPUShaderStage m_stages{};
+    std::vector<MGPUPushConstantRange> m_push_constant_ranges;
 };
 
 } // namespace mgpu
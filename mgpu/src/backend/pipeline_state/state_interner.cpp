@@ -0,0 +1,133 @@
+
+#include <type_traits>
+
+#include "state_interner.hpp"
+
+namespace mgpu {
+
+namespace {
+
+// Identifies the type of the state in the key, since all state types share one map.
+enum class StateType : u8 {
+  Rasterizer,
+  InputAssembly,
+  ColorBlend,
+  VertexInput,
+  DepthStencil
+};
+
+// Keys are built field by field, so that padding bytes of the create info structures never end up in the key.
+template<typename T>
+void Append(std::string& key, const T& value) {
+  static_assert(std::is_scalar_v<T>);
+  key.append((const char*)&value, sizeof(T));
+}
+
+void Append(std::string& key, const MGPUStencilFaceState& stencil_face_state) {
+  Append(key, stencil_face_state.fail_op);
+  Append(key, stencil_face_state.pass_op);
+  Append(key, stencil_face_state.depth_fail_op);
+  Append(key, stencil_face_state.compare_op);
+  Append(key, stencil_face_state.read_mask);
+  Append(key, stencil_face_state.write_mask);
+  Append(key, stencil_face_state.reference);
+}
+
+} // anonymous namespace
+
+void InternedStateBase::Release() {
+  m_interner->Release(this);
+}
+
+StateInterner::~StateInterner() {
+  // Destroy any states which are still referenced, like the device's default states.
+  for(const auto& [key, state] : m_states) {
+    delete state;
+  }
+}
+
+void StateInterner::Release(InternedStateBase* state) {
+  std::lock_guard lock_guard{m_mutex};
+
+  if(--state->m_reference_count == 0u) {
+    m_states.erase(state->m_key);
+    delete state;
+  }
+}
+
+std::string StateInterner::MakeKey(const MGPURasterizerStateCreateInfo& create_info) {
+  std::string key{};
+  Append(key, StateType::Rasterizer);
+  Append(key, create_info.depth_clamp_enable);
+  Append(key, create_info.rasterizer_discard_enable);
+  Append(key, create_info.polygon_mode);
+  Append(key, create_info.cull_mode);
+  Append(key, create_info.front_face);
+  Append(key, create_info.depth_bias_enable);
+  Append(key, create_info.depth_bias_constant_factor);
+  Append(key, create_info.depth_bias_clamp);
+  Append(key, create_info.depth_bias_slope_factor);
+  Append(key, create_info.line_width);
+  return key;
+}
+
+std::string StateInterner::MakeKey(const MGPUInputAssemblyStateCreateInfo& create_info) {
+  std::string key{};
+  Append(key, StateType::InputAssembly);
+  Append(key, create_info.topology);
+  Append(key, create_info.primitive_restart_enable);
+  return key;
+}
+
+std::string StateInterner::MakeKey(const MGPUColorBlendStateCreateInfo& create_info) {
+  std::string key{};
+  Append(key, StateType::ColorBlend);
+  Append(key, create_info.attachment_count);
+  for(u32 i = 0; i < create_info.attachment_count; i++) {
+    const MGPUColorBlendAttachmentState& attachment = create_info.attachments[i];
+    Append(key, attachment.blend_enable);
+    Append(key, attachment.src_color_blend_factor);
+    Append(key, attachment.dst_color_blend_factor);
+    Append(key, attachment.color_blend_op);
+    Append(key, attachment.src_alpha_blend_factor);
+    Append(key, attachment.dst_alpha_blend_factor);
+    Append(key, attachment.alpha_blend_op);
+    Append(key, attachment.color_write_mask);
+  }
+  return key;
+}
+
+std::string StateInterner::MakeKey(const MGPUVertexInputStateCreateInfo& create_info) {
+  std::string key{};
+  Append(key, StateType::VertexInput);
+  Append(key, create_info.binding_count);
+  for(u32 i = 0; i < create_info.binding_count; i++) {
+    const MGPUVertexBinding& binding = create_info.bindings[i];
+    Append(key, binding.binding);
+    Append(key, binding.stride);
+    Append(key, binding.input_rate);
+  }
+  Append(key, create_info.attribute_count);
+  for(u32 i = 0; i < create_info.attribute_count; i++) {
+    const MGPUVertexAttribute& attribute = create_info.attributes[i];
+    Append(key, attribute.location);
+    Append(key, attribute.binding);
+    Append(key, attribute.format);
+    Append(key, attribute.offset);
+  }
+  return key;
+}
+
+std::string StateInterner::MakeKey(const MGPUDepthStencilStateCreateInfo& create_info) {
+  std::string key{};
+  Append(key, StateType::DepthStencil);
+  Append(key, create_info.depth_test_enable);
+  Append(key, create_info.depth_write_enable);
+  Append(key, create_info.depth_compare_op);
+  Append(key, create_info.stencil_test_enable);
+  Append(key, create_info.stencil_front);
+  Append(key, create_info.stencil_back);
+  return key;
+}
+
+} // namespace mgpu
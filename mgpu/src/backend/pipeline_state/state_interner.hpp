@@ -0,0 +1,84 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "common/result.hpp"
+
+namespace mgpu {
+
+class StateInterner;
+
+/**
+ * Base class of all fixed-function pipeline state objects.
+ * State objects are shared between all create infos with identical contents and are released instead of deleted.
+ */
+class InternedStateBase : atom::NonCopyable, atom::NonMoveable {
+  public:
+    virtual ~InternedStateBase() = default;
+
+    void Release();
+
+  private:
+    friend class StateInterner;
+
+    StateInterner* m_interner{};
+    std::string m_key{};
+    u32 m_reference_count{};
+};
+
+/**
+ * Deduplicates pipeline state objects by the contents of their create info.
+ * Pipelines are cached by the addresses of their state objects, so handing out a single object per unique create info
+ * ensures that equivalent states map to the same pipeline.
+ */
+class StateInterner : atom::NonCopyable, atom::NonMoveable {
+  public:
+    StateInterner() = default;
+   ~StateInterner();
+
+    template<typename T, typename TCreateInfo, typename TFactory>
+    Result<T*> GetOrCreate(const TCreateInfo& create_info, TFactory&& factory) {
+      std::string key = MakeKey(create_info);
+
+      std::lock_guard lock_guard{m_mutex};
+
+      if(const auto match = m_states.find(key); match != m_states.end()) {
+        match->second->m_reference_count++;
+        return static_cast<T*>(match->second);
+      }
+
+      Result<T*> state_result = factory(create_info);
+      MGPU_FORWARD_ERROR(state_result.Code());
+
+      T* const state = state_result.Unwrap();
+      state->m_interner = this;
+      state->m_key = key;
+      state->m_reference_count = 1u;
+      m_states.emplace(std::move(key), state);
+      return state;
+    }
+
+  private:
+    friend class InternedStateBase;
+
+    void Release(InternedStateBase* state);
+
+    static std::string MakeKey(const MGPURasterizerStateCreateInfo& create_info);
+    static std::string MakeKey(const MGPUInputAssemblyStateCreateInfo& create_info);
+    static std::string MakeKey(const MGPUColorBlendStateCreateInfo& create_info);
+    static std::string MakeKey(const MGPUVertexInputStateCreateInfo& create_info);
+    static std::string MakeKey(const MGPUDepthStencilStateCreateInfo& create_info);
+
+    std::mutex m_mutex{};
+    std::unordered_map<std::string, InternedStateBase*> m_states{};
+};
+
+} // namespace mgpu
@@ -7,19 +7,40 @@
 #include <atom/non_moveable.hpp>
 
 #include "backend/command_list/command_list.hpp"
+#include "common/result.hpp"
 
 namespace mgpu {
 
 class BufferBase;
+class ResourceSetBase;
 class TextureBase;
 
 class QueueBase : atom::NonCopyable, atom::NonMoveable {
   public:
+    struct TransientAllocation {
+      BufferBase* buffer;
+      u64 offset;
+      void* address;
+    };
+
+    // Transient memory is written by the host only, so it can be used in any way except as a copy destination.
+    static constexpr MGPUBufferUsage k_transient_buffer_usage =
+      MGPU_BUFFER_USAGE_COPY_SRC |
+      MGPU_BUFFER_USAGE_UNIFORM_BUFFER |
+      MGPU_BUFFER_USAGE_STORAGE_BUFFER |
+      MGPU_BUFFER_USAGE_INDEX_BUFFER |
+      MGPU_BUFFER_USAGE_VERTEX_BUFFER |
+      MGPU_BUFFER_USAGE_INDIRECT_BUFFER;
+
     virtual ~QueueBase() = default;
 
     virtual MGPUResult SubmitCommandList(const CommandList* command_list) = 0;
     virtual MGPUResult BufferUpload(const BufferBase* buffer, std::span<const u8> data, u64 offset) = 0;
     virtual MGPUResult TextureUpload(const TextureBase* texture, const MGPUTextureUploadRegion& region, const void* data) = 0;
+    virtual Result<TransientAllocation> AllocateTransient(u64 size, u64 alignment, MGPUBufferUsage usage) = 0;
+
+    /// Like transient allocations, transient resource sets are owned by the queue and are only valid until its next flush.
+    virtual Result<ResourceSetBase*> CreateTransientResourceSet(const MGPUResourceSetCreateInfo& create_info) = 0;
     virtual MGPUResult Flush() = 0;
 };
 
@@ -1,14 +1,46 @@
 
 #pragma once
 
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
 #include <atom/non_copyable.hpp>
 #include <atom/non_moveable.hpp>
+#include <span>
+#include <vector>
+
+#include "backend/resource_set_layout.hpp"
 
 namespace mgpu {
 
 class ResourceSetBase : atom::NonCopyable, atom::NonMoveable {
   public:
+    // The layout may be destroyed before the resource set, so the information needed for binding is copied.
+    explicit ResourceSetBase(const MGPUResourceSetCreateInfo& create_info) {
+      const std::span<const MGPUResourceBindingType> dynamic_binding_types = ((const ResourceSetLayoutBase*)create_info.layout)->GetDynamicBindingTypes();
+      m_dynamic_binding_types.assign(dynamic_binding_types.begin(), dynamic_binding_types.end());
+    }
+
     virtual ~ResourceSetBase() = default;
+
+    /// Checks that there is a suitably aligned dynamic offset for each dynamic binding of the resource set.
+    [[nodiscard]] bool AreDynamicOffsetsValid(const MGPUPhysicalDeviceLimits& limits, std::span<const u32> dynamic_offsets) const {
+      if(dynamic_offsets.size() != m_dynamic_binding_types.size()) {
+        return false;
+      }
+
+      for(size_t i = 0u; i < dynamic_offsets.size(); i++) {
+        const u64 alignment = m_dynamic_binding_types[i] == MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER_DYNAMIC ?
+          limits.min_uniform_buffer_offset_alignment : limits.min_storage_buffer_offset_alignment;
+        if(dynamic_offsets[i] % alignment != 0u) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+  private:
+    std::vector<MGPUResourceBindingType> m_dynamic_binding_types{};
 };
 
 } // namespace mgpu
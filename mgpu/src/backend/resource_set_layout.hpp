@@ -1,14 +1,44 @@
 
 #pragma once
 
+#include <mgpu/mgpu.h>
 #include <atom/non_copyable.hpp>
 #include <atom/non_moveable.hpp>
+#include <algorithm>
+#include <span>
+#include <vector>
 
 namespace mgpu {
 
 class ResourceSetLayoutBase : atom::NonCopyable, atom::NonMoveable {
   public:
+    explicit ResourceSetLayoutBase(const MGPUResourceSetLayoutCreateInfo& create_info) {
+      std::vector<const MGPUResourceSetLayoutBinding*> dynamic_bindings{};
+
+      for(size_t i = 0u; i < create_info.binding_count; i++) {
+        const MGPUResourceSetLayoutBinding& binding = create_info.bindings[i];
+        if(binding.type == MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER_DYNAMIC || binding.type == MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER_DYNAMIC) {
+          dynamic_bindings.push_back(&binding);
+        }
+      }
+
+      // Dynamic offsets are consumed in the order of the binding numbers, regardless of the order in which the bindings were declared.
+      std::sort(dynamic_bindings.begin(), dynamic_bindings.end(), [](const MGPUResourceSetLayoutBinding* a, const MGPUResourceSetLayoutBinding* b) {
+        return a->binding < b->binding;
+      });
+
+      for(const MGPUResourceSetLayoutBinding* binding : dynamic_bindings) {
+        m_dynamic_binding_types.push_back(binding->type);
+      }
+    }
+
     virtual ~ResourceSetLayoutBase() = default;
+
+    /// The types of the bindings which take a dynamic offset, in the order in which the offsets are passed when binding a resource set.
+    [[nodiscard]] std::span<const MGPUResourceBindingType> GetDynamicBindingTypes() const { return m_dynamic_binding_types; }
+
+  private:
+    std::vector<MGPUResourceBindingType> m_dynamic_binding_types{};
 };
 
 } // namespace mgpu
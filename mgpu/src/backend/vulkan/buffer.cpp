@@ -19,6 +19,8 @@ Buffer::Buffer(Device* device, VkBuffer vk_buffer, VmaAllocation vma_allocation,
 Buffer::~Buffer() {
   Unmap();
 
+  m_device->DiscardPendingUploads(this);
+
   // Defer deletion of underlying Vulkan resources until the currently recorded frame has been fully processed on the GPU.
   // TODO(fleroviux): make this a little bit less verbose.
   Device* device = m_device;
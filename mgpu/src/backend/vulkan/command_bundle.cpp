@@ -0,0 +1,73 @@
+
+#include "lib/vulkan_result.hpp"
+#include "command_bundle.hpp"
+#include "device.hpp"
+#include "queue.hpp"
+
+namespace mgpu::vulkan {
+
+CommandBundle::CommandBundle(
+  Device* device,
+  const CommandList& command_list,
+  VkCommandPool vk_cmd_pool,
+  VkCommandBuffer vk_cmd_buffer,
+  std::vector<GraphicsPipelineCache::PipelinePin>&& pipeline_pins
+)   : CommandBundleBase{command_list}
+    , m_device{device}
+    , m_vk_cmd_pool{vk_cmd_pool}
+    , m_vk_cmd_buffer{vk_cmd_buffer}
+    , m_pipeline_pins{std::move(pipeline_pins)} {
+}
+
+CommandBundle::~CommandBundle() {
+  // Destroying the command pool also frees the command buffer that was allocated from it.
+  VkDevice vk_device = m_device->Handle();
+  VkCommandPool vk_cmd_pool = m_vk_cmd_pool;
+  m_device->GetDeleterQueue().Schedule([vk_device, vk_cmd_pool]() {
+    vkDestroyCommandPool(vk_device, vk_cmd_pool, nullptr);
+  });
+
+  // Evicted pipelines are destroyed through the deleter queue as well, so the pins may be released right away.
+}
+
+Result<CommandBundleBase*> CommandBundle::Create(Device* device, const CommandList* command_list) {
+  VkDevice vk_device = device->Handle();
+  Queue& queue = device->GetCommandQueue();
+
+  // Each bundle gets its own command pool, so that bundles can be created and destroyed independently of the queue.
+  const VkCommandPoolCreateInfo vk_cmd_pool_create_info{
+    .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+    .pNext = nullptr,
+    .flags = 0,
+    .queueFamilyIndex = queue.GetQueueFamilyIndex()
+  };
+
+  VkCommandPool vk_cmd_pool{};
+  MGPU_VK_FORWARD_ERROR(vkCreateCommandPool(vk_device, &vk_cmd_pool_create_info, nullptr, &vk_cmd_pool));
+
+  const VkCommandBufferAllocateInfo vk_cmd_buffer_alloc_info{
+    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+    .pNext = nullptr,
+    .commandPool = vk_cmd_pool,
+    .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+    .commandBufferCount = 1u
+  };
+
+  VkCommandBuffer vk_cmd_buffer{};
+  VkResult vk_result = vkAllocateCommandBuffers(vk_device, &vk_cmd_buffer_alloc_info, &vk_cmd_buffer);
+  if(vk_result != VK_SUCCESS) {
+    vkDestroyCommandPool(vk_device, vk_cmd_pool, nullptr);
+    return VkResultToMGPUResult(vk_result);
+  }
+
+  std::vector<GraphicsPipelineCache::PipelinePin> pipeline_pins{};
+  const MGPUResult result = queue.RecordCommandBundle(vk_cmd_buffer, command_list, pipeline_pins);
+  if(result != MGPU_SUCCESS) {
+    vkDestroyCommandPool(vk_device, vk_cmd_pool, nullptr);
+    return result;
+  }
+
+  return new CommandBundle{device, *command_list, vk_cmd_pool, vk_cmd_buffer, std::move(pipeline_pins)};
+}
+
+}  // namespace mgpu::vulkan
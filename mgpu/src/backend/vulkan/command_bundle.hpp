@@ -0,0 +1,41 @@
+
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "backend/command_list/command_list.hpp"
+#include "backend/command_bundle.hpp"
+#include "common/result.hpp"
+#include "graphics_pipeline_cache.hpp"
+
+namespace mgpu::vulkan {
+
+class Device;
+
+class CommandBundle final : public CommandBundleBase {
+  public:
+   ~CommandBundle() override;
+
+    static Result<CommandBundleBase*> Create(Device* device, const CommandList* command_list);
+
+    [[nodiscard]] VkCommandBuffer Handle() const { return m_vk_cmd_buffer; }
+
+  private:
+    CommandBundle(
+      Device* device,
+      const CommandList& command_list,
+      VkCommandPool vk_cmd_pool,
+      VkCommandBuffer vk_cmd_buffer,
+      std::vector<GraphicsPipelineCache::PipelinePin>&& pipeline_pins
+    );
+
+    Device* m_device;
+    VkCommandPool m_vk_cmd_pool;
+    VkCommandBuffer m_vk_cmd_buffer;
+
+    // The secondary command buffer references the pipelines directly, so they must not be evicted before it is destroyed.
+    std::vector<GraphicsPipelineCache::PipelinePin> m_pipeline_pins;
+};
+
+}  // namespace mgpu::vulkan
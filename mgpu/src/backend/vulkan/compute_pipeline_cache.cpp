@@ -0,0 +1,70 @@
+
+#include "backend/vulkan/lib/vulkan_result.hpp"
+#include "pipeline_state/shader_program.hpp"
+#include "compute_pipeline_cache.hpp"
+
+namespace mgpu::vulkan {
+
+ComputePipelineCache::ComputePipelineCache(VkDevice vk_device, VkPipelineCache vk_pipeline_cache, std::shared_ptr<DeleterQueue> deleter_queue)
+    : m_vk_device{vk_device}
+    , m_vk_pipeline_cache{vk_pipeline_cache}
+    , m_deleter_queue{std::move(deleter_queue)} {
+}
+
+ComputePipelineCache::~ComputePipelineCache() {
+  m_shader_program_to_vk_pipeline.ForEach([&](const ShaderProgram*, VkPipeline vk_pipeline) {
+    DestroyPipeline(vk_pipeline);
+  });
+}
+
+Result<VkPipeline> ComputePipelineCache::GetPipeline(const ShaderProgram* shader_program) {
+  const size_t hash = std::hash<const ShaderProgram*>{}(shader_program);
+
+  // The cache is shared by all queues, which may record command lists on different threads.
+  std::lock_guard lock_guard{m_mutex};
+
+  if(const VkPipeline* vk_pipeline = m_shader_program_to_vk_pipeline.Find(shader_program, hash); vk_pipeline != nullptr) {
+    return *vk_pipeline;
+  }
+
+  const std::span<const VkPipelineShaderStageCreateInfo> vk_shader_stages = shader_program->GetVkShaderStages();
+  if(vk_shader_stages.size() != 1u || vk_shader_stages[0].stage != VK_SHADER_STAGE_COMPUTE_BIT) {
+    return MGPU_INTERNAL_ERROR;
+  }
+
+  const VkComputePipelineCreateInfo vk_compute_pipeline_create_info{
+    .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+    .pNext = nullptr,
+    .flags = 0,
+    .stage = vk_shader_stages[0],
+    .layout = shader_program->GetVkPipelineLayout(),
+    .basePipelineHandle = VK_NULL_HANDLE,
+    .basePipelineIndex = 0
+  };
+
+  VkPipeline vk_pipeline{};
+  MGPU_VK_FORWARD_ERROR(vkCreateComputePipelines(m_vk_device, m_vk_pipeline_cache, 1u, &vk_compute_pipeline_create_info, nullptr, &vk_pipeline));
+  *m_shader_program_to_vk_pipeline.TryEmplace(shader_program, hash).first = vk_pipeline;
+  return vk_pipeline;
+}
+
+void ComputePipelineCache::Invalidate(const ShaderProgram* shader_program) {
+  const size_t hash = std::hash<const ShaderProgram*>{}(shader_program);
+
+  std::lock_guard lock_guard{m_mutex};
+
+  if(const VkPipeline* vk_pipeline = m_shader_program_to_vk_pipeline.Find(shader_program, hash); vk_pipeline != nullptr) {
+    DestroyPipeline(*vk_pipeline);
+    m_shader_program_to_vk_pipeline.Erase(shader_program, hash);
+  }
+}
+
+void ComputePipelineCache::DestroyPipeline(VkPipeline vk_pipeline) {
+  // Defer deletion of underlying Vulkan resources until the currently recorded frame has been fully processed on the GPU.
+  VkDevice vk_device = m_vk_device;
+  m_deleter_queue->Schedule([vk_device, vk_pipeline]() {
+    vkDestroyPipeline(vk_device, vk_pipeline, nullptr);
+  });
+}
+
+} // namespace mgpu::vulkan
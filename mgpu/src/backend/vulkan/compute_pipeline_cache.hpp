@@ -0,0 +1,43 @@
+
+#pragma once
+
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <memory>
+#include <mutex>
+#include <vulkan/vulkan.h>
+
+#include "common/flat_hash_map.hpp"
+#include "common/result.hpp"
+#include "deleter_queue.hpp"
+
+namespace mgpu::vulkan {
+
+class ShaderProgram;
+
+/**
+ * Caches compute pipelines for all queues of a device.
+ * A compute pipeline only depends on its shader program, so pipelines are keyed by the shader program
+ * and destroyed together with it.
+ */
+class ComputePipelineCache : atom::NonCopyable, atom::NonMoveable {
+  public:
+    ComputePipelineCache(VkDevice vk_device, VkPipelineCache vk_pipeline_cache, std::shared_ptr<DeleterQueue> deleter_queue);
+   ~ComputePipelineCache();
+
+    Result<VkPipeline> GetPipeline(const ShaderProgram* shader_program);
+
+    /// Destroys the pipeline of the shader program. Must be called when the shader program is destroyed.
+    void Invalidate(const ShaderProgram* shader_program);
+
+  private:
+    void DestroyPipeline(VkPipeline vk_pipeline);
+
+    VkDevice m_vk_device;
+    VkPipelineCache m_vk_pipeline_cache;
+    std::shared_ptr<DeleterQueue> m_deleter_queue;
+    std::mutex m_mutex{};
+    FlatHashMap<const ShaderProgram*, VkPipeline> m_shader_program_to_vk_pipeline{};
+};
+
+} // namespace mgpu::vulkan
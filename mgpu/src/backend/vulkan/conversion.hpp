@@ -145,12 +145,14 @@ inline VkShaderStageFlags MGPUShaderStagesToVkShaderStageFlags(MGPUShaderStage s
 
 inline VkDescriptorType MGPUResourceBindingTypeToVkDescriptorType(MGPUResourceBindingType resource_binding_type) {
   switch(resource_binding_type) {
-    case MGPU_RESOURCE_BINDING_TYPE_SAMPLER:             return VK_DESCRIPTOR_TYPE_SAMPLER;
-    case MGPU_RESOURCE_BINDING_TYPE_TEXTURE_AND_SAMPLER: return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    case MGPU_RESOURCE_BINDING_TYPE_SAMPLED_TEXTURE:     return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-    case MGPU_RESOURCE_BINDING_TYPE_STORAGE_TEXTURE:     return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    case MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER:      return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    case MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER:      return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    case MGPU_RESOURCE_BINDING_TYPE_SAMPLER:                return VK_DESCRIPTOR_TYPE_SAMPLER;
+    case MGPU_RESOURCE_BINDING_TYPE_TEXTURE_AND_SAMPLER:    return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    case MGPU_RESOURCE_BINDING_TYPE_SAMPLED_TEXTURE:        return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    case MGPU_RESOURCE_BINDING_TYPE_STORAGE_TEXTURE:        return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    case MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER:         return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    case MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER:         return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    case MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER_DYNAMIC: return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    case MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER_DYNAMIC: return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     default: ATOM_PANIC("unhandled resource binding type: {}", (int)resource_binding_type);
   }
 }
@@ -1,24 +1,86 @@
-
+#include <atom/panic.hpp>
+#include <iterator>
 #include <limits>
 
 #include "deleter_queue.hpp"
 
 namespace mgpu::vulkan {
 
+u32 DeleterQueue::AddTimeline(VkDevice vk_device, VkSemaphore vk_timeline_semaphore) {
+  std::lock_guard lock_guard{m_mutex};
+  if(m_timeline_count == k_max_timeline_count) {
+    ATOM_PANIC("mgpu: Vulkan: too many timelines for the deleter queue");
+  }
+  m_timelines[m_timeline_count] = {vk_device, vk_timeline_semaphore};
+  return m_timeline_count++;
+}
+
+void DeleterQueue::RemoveTimeline(u32 timeline) {
+  std::lock_guard lock_guard{m_mutex};
+  m_timelines[timeline].vk_timeline_semaphore = VK_NULL_HANDLE;
+}
+
 void DeleterQueue::Schedule(DeletionFn deletion) {
-  m_pending_deletions.emplace_back(std::move(deletion), m_current_timestamp);
+  Timestamps timestamps{};
+  for(size_t timeline = 0u; timeline < k_max_timeline_count; timeline++) {
+    timestamps[timeline] = m_current_timestamps[timeline].load(std::memory_order_relaxed);
+  }
+
+  std::lock_guard lock_guard{m_mutex};
+  m_pending_deletions.emplace_back(std::move(deletion), timestamps);
 }
 
-void DeleterQueue::Drain(u64 until_timestamp) {
-  size_t i = 0;
-  while(i < m_pending_deletions.size() && m_pending_deletions[i].timestamp <= until_timestamp) {
-    m_pending_deletions[i++].deletion_fn();
+void DeleterQueue::Drain() {
+  std::vector<PendingDelete> completed_deletions{};
+  {
+    std::lock_guard lock_guard{m_mutex};
+
+    // Timelines which have not been added or which have been removed do not hold back any deletions.
+    Timestamps completed_timestamps{};
+    completed_timestamps.fill(std::numeric_limits<u64>::max());
+    for(size_t timeline = 0u; timeline < m_timeline_count; timeline++) {
+      const Timeline& current_timeline = m_timelines[timeline];
+      if(current_timeline.vk_timeline_semaphore != VK_NULL_HANDLE &&
+         vkGetSemaphoreCounterValue(current_timeline.vk_device, current_timeline.vk_timeline_semaphore, &completed_timestamps[timeline]) != VK_SUCCESS) {
+        return;
+      }
+    }
+
+    // Timestamps never decrease, so the deletions which have been reached on every timeline form a prefix of the queue.
+    const auto IsCompleted = [&](const PendingDelete& pending_delete) {
+      for(size_t timeline = 0u; timeline < k_max_timeline_count; timeline++) {
+        if(pending_delete.timestamps[timeline] > completed_timestamps[timeline]) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    size_t i = 0;
+    while(i < m_pending_deletions.size() && IsCompleted(m_pending_deletions[i])) {
+      i++;
+    }
+    completed_deletions.assign(std::make_move_iterator(m_pending_deletions.begin()), std::make_move_iterator(m_pending_deletions.begin() + i));
+    m_pending_deletions.erase(m_pending_deletions.begin(), m_pending_deletions.begin() + i);
+  }
+
+  // Run the deletions without holding the lock, since they may schedule further deletions.
+  for(PendingDelete& pending_delete : completed_deletions) {
+    pending_delete.deletion_fn();
   }
-  m_pending_deletions.erase(m_pending_deletions.begin(), m_pending_deletions.begin() + i);
 }
 
 void DeleterQueue::DrainAll() {
-  Drain(std::numeric_limits<u64>::max());
+  std::vector<PendingDelete> pending_deletions{};
+  {
+    std::lock_guard lock_guard{m_mutex};
+    pending_deletions = std::move(m_pending_deletions);
+    m_pending_deletions.clear();
+  }
+
+  for(PendingDelete& pending_delete : pending_deletions) {
+    pending_delete.deletion_fn();
+  }
 }
 
 }  // namespace mgpu::vulkan
@@ -2,8 +2,12 @@
 #pragma once
 
 #include <atom/integer.hpp>
+#include <array>
+#include <atomic>
 #include <functional>
+#include <mutex>
 #include <vector>
+#include <vulkan/vulkan.h>
 
 namespace mgpu::vulkan {
 
@@ -11,20 +15,43 @@ class DeleterQueue {
   public:
     using DeletionFn = std::function<void(void)>;
 
+    // One timeline for the graphics and compute queue and one for the dedicated compute queue.
+    static constexpr size_t k_max_timeline_count = 2u;
+
+    /**
+     * Every queue registers its timeline semaphore and keeps the timestamp of the timeline up-to-date:
+     * the value that the next submission will signal while the command buffer being recorded may reference resources,
+     * and the value of the last submission otherwise. A deletion is only run once it has been reached on every timeline.
+     * Deletions may be scheduled from any thread, for example when the graphics pipeline cache evicts pipelines.
+     */
+    u32 AddTimeline(VkDevice vk_device, VkSemaphore vk_timeline_semaphore);
+
+    /// Must be called before the timeline semaphore is destroyed, once all submissions have completed.
+    void RemoveTimeline(u32 timeline);
+
     void Schedule(DeletionFn deletion_fn);
-    void Drain(u64 until_timestamp);
+    void Drain();
     void DrainAll();
-    [[nodiscard]] u64 GetTimestamp() const { return m_current_timestamp; }
-    void BumpTimestamp() { m_current_timestamp++; }
+    void SetTimestamp(u32 timeline, u64 timestamp) { m_current_timestamps[timeline].store(timestamp, std::memory_order_relaxed); }
 
   private:
+    using Timestamps = std::array<u64, k_max_timeline_count>;
+
+    struct Timeline {
+      VkDevice vk_device{};
+      VkSemaphore vk_timeline_semaphore{}; // Null if the timeline has been removed, in which case it has completed.
+    };
+
     struct PendingDelete {
       DeletionFn deletion_fn;
-      u64 timestamp{};
+      Timestamps timestamps{};
     };
 
+    std::mutex m_mutex{};
     std::vector<PendingDelete> m_pending_deletions{};
-    u64 m_current_timestamp{};
+    std::array<Timeline, k_max_timeline_count> m_timelines{};
+    u32 m_timeline_count{};
+    std::array<std::atomic<u64>, k_max_timeline_count> m_current_timestamps{};
 };
 
 }  // namespace mgpu::vulkan
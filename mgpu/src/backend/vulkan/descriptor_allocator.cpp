@@ -0,0 +1,203 @@
+
+#include <atom/vector_n.hpp>
+#include <algorithm>
+
+#include "backend/vulkan/lib/vulkan_result.hpp"
+#include "descriptor_allocator.hpp"
+
+namespace mgpu::vulkan {
+
+static VkResult AllocateDescriptorSet(VkDevice vk_device, VkDescriptorPool vk_descriptor_pool, VkDescriptorSetLayout vk_descriptor_set_layout, VkDescriptorSet& vk_descriptor_set) {
+  const VkDescriptorSetAllocateInfo vk_allocate_info{
+    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+    .pNext = nullptr,
+    .descriptorPool = vk_descriptor_pool,
+    .descriptorSetCount = 1u,
+    .pSetLayouts = &vk_descriptor_set_layout
+  };
+  return vkAllocateDescriptorSets(vk_device, &vk_allocate_info, &vk_descriptor_set);
+}
+
+static bool IsPoolExhausted(VkResult vk_result) {
+  return vk_result == VK_ERROR_OUT_OF_POOL_MEMORY || vk_result == VK_ERROR_FRAGMENTED_POOL;
+}
+
+void DescriptorPoolSizer::Record(const DescriptorCounts& descriptor_counts) {
+  m_requested_set_count++;
+  for(size_t type = 0u; type < descriptor_counts.size(); type++) {
+    m_requested_descriptor_counts[type] += descriptor_counts[type];
+  }
+}
+
+Result<VkDescriptorPool> DescriptorPoolSizer::CreatePool(VkDevice vk_device, VkDescriptorPoolCreateFlags vk_flags, u32 max_sets, const DescriptorCounts& descriptor_counts) const {
+  atom::Vector_N<VkDescriptorPoolSize, std::tuple_size_v<DescriptorCounts>> vk_descriptor_pool_sizes{};
+  for(size_t type = 0u; type < descriptor_counts.size(); type++) {
+    const u64 requested_descriptor_count = m_requested_descriptor_counts[type];
+    if(requested_descriptor_count != 0u || descriptor_counts[type] != 0u) {
+      const u64 average_descriptor_count = m_requested_set_count == 0u ? 0u :
+        (requested_descriptor_count * max_sets + m_requested_set_count - 1u) / m_requested_set_count;
+      vk_descriptor_pool_sizes.PushBack({
+        .type = (VkDescriptorType)type,
+        .descriptorCount = (u32)std::max<u64>(average_descriptor_count, descriptor_counts[type])
+      });
+    }
+  }
+
+  const VkDescriptorPoolCreateInfo vk_descriptor_pool_create_info{
+    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+    .pNext = nullptr,
+    .flags = vk_flags,
+    .maxSets = max_sets,
+    .poolSizeCount = (u32)vk_descriptor_pool_sizes.Size(),
+    .pPoolSizes = vk_descriptor_pool_sizes.Data()
+  };
+
+  VkDescriptorPool vk_descriptor_pool{};
+  MGPU_VK_FORWARD_ERROR(vkCreateDescriptorPool(vk_device, &vk_descriptor_pool_create_info, nullptr, &vk_descriptor_pool));
+  return vk_descriptor_pool;
+}
+
+DescriptorAllocator::DescriptorAllocator(VkDevice vk_device) : m_vk_device{vk_device} {
+}
+
+DescriptorAllocator::~DescriptorAllocator() {
+  // Destroying the pools implicitly frees all descriptor sets allocated from them.
+  for(const DescriptorPool& descriptor_pool : m_descriptor_pools) {
+    vkDestroyDescriptorPool(m_vk_device, descriptor_pool.vk_descriptor_pool, nullptr);
+  }
+}
+
+DescriptorAllocator::LayoutKey DescriptorAllocator::RegisterLayout() {
+  std::lock_guard lock_guard{m_mutex};
+  const LayoutKey layout_key = m_next_layout_key++;
+  m_free_allocations.try_emplace(layout_key);
+  return layout_key;
+}
+
+void DescriptorAllocator::ReleaseLayout(LayoutKey layout_key) {
+  std::lock_guard lock_guard{m_mutex};
+
+  const auto match = m_free_allocations.find(layout_key);
+  if(match == m_free_allocations.end()) {
+    return;
+  }
+
+  // Descriptor sets must not be updated anymore once their layout has been destroyed, so they cannot be reused.
+  for(const Allocation& allocation : match->second) {
+    FreeDescriptorSet(allocation);
+  }
+  m_free_allocations.erase(match);
+}
+
+Result<DescriptorAllocator::Allocation> DescriptorAllocator::Allocate(LayoutKey layout_key, VkDescriptorSetLayout vk_descriptor_set_layout, const DescriptorCounts& descriptor_counts) {
+  std::lock_guard lock_guard{m_mutex};
+
+  if(const auto match = m_free_allocations.find(layout_key); match != m_free_allocations.end() && !match->second.empty()) {
+    const Allocation allocation = match->second.back();
+    match->second.pop_back();
+    return allocation;
+  }
+
+  m_pool_sizer.Record(descriptor_counts);
+
+  VkDescriptorSet vk_descriptor_set{};
+
+  // Try the most recent pool first, since it is the least likely to be exhausted.
+  // Older pools are only tried when descriptor sets have been freed back to them, since they have been exhausted before.
+  for(auto it = m_descriptor_pools.rbegin(); it != m_descriptor_pools.rend(); ++it) {
+    if(!it->may_have_space) {
+      continue;
+    }
+
+    const VkResult vk_result = AllocateDescriptorSet(m_vk_device, it->vk_descriptor_pool, vk_descriptor_set_layout, vk_descriptor_set);
+    if(vk_result == VK_SUCCESS) {
+      return Allocation{it->vk_descriptor_pool, vk_descriptor_set};
+    }
+    if(!IsPoolExhausted(vk_result)) {
+      return VkResultToMGPUResult(vk_result);
+    }
+    it->may_have_space = false;
+  }
+
+  // Each pool holds twice as many descriptor sets as the pool before it, up to a limit.
+  u32 max_sets = k_initial_pool_set_count;
+  for(size_t i = 0u; i < m_descriptor_pools.size() && max_sets < k_max_pool_set_count; i++) {
+    max_sets *= 2u;
+  }
+
+  // Individual descriptor sets are freed back to the pool once their layout is released.
+  Result<VkDescriptorPool> vk_descriptor_pool_result = m_pool_sizer.CreatePool(m_vk_device, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, max_sets, descriptor_counts);
+  MGPU_FORWARD_ERROR(vk_descriptor_pool_result.Code());
+
+  const VkDescriptorPool vk_descriptor_pool = vk_descriptor_pool_result.Unwrap();
+  m_descriptor_pools.push_back({vk_descriptor_pool, true});
+  MGPU_VK_FORWARD_ERROR(AllocateDescriptorSet(m_vk_device, vk_descriptor_pool, vk_descriptor_set_layout, vk_descriptor_set));
+  return Allocation{vk_descriptor_pool, vk_descriptor_set};
+}
+
+void DescriptorAllocator::Free(LayoutKey layout_key, const Allocation& allocation) {
+  std::lock_guard lock_guard{m_mutex};
+
+  if(const auto match = m_free_allocations.find(layout_key); match != m_free_allocations.end()) {
+    match->second.push_back(allocation);
+  } else {
+    // The layout has been released already.
+    FreeDescriptorSet(allocation);
+  }
+}
+
+void DescriptorAllocator::FreeDescriptorSet(const Allocation& allocation) {
+  vkFreeDescriptorSets(m_vk_device, allocation.vk_descriptor_pool, 1u, &allocation.vk_descriptor_set);
+
+  for(DescriptorPool& descriptor_pool : m_descriptor_pools) {
+    if(descriptor_pool.vk_descriptor_pool == allocation.vk_descriptor_pool) {
+      descriptor_pool.may_have_space = true;
+      break;
+    }
+  }
+}
+
+TransientDescriptorAllocator::TransientDescriptorAllocator(VkDevice vk_device) : m_vk_device{vk_device} {
+}
+
+TransientDescriptorAllocator::~TransientDescriptorAllocator() {
+  for(VkDescriptorPool vk_descriptor_pool : m_vk_descriptor_pools) {
+    vkDestroyDescriptorPool(m_vk_device, vk_descriptor_pool, nullptr);
+  }
+}
+
+Result<VkDescriptorSet> TransientDescriptorAllocator::Allocate(VkDescriptorSetLayout vk_descriptor_set_layout, const DescriptorCounts& descriptor_counts) {
+  m_pool_sizer.Record(descriptor_counts);
+
+  VkDescriptorSet vk_descriptor_set{};
+
+  // Move on to the next pool once a pool is exhausted. The pools from previous uses are tried before creating a new one.
+  for(; m_current_pool < m_vk_descriptor_pools.size(); m_current_pool++) {
+    const VkResult vk_result = AllocateDescriptorSet(m_vk_device, m_vk_descriptor_pools[m_current_pool], vk_descriptor_set_layout, vk_descriptor_set);
+    if(vk_result == VK_SUCCESS) {
+      return vk_descriptor_set;
+    }
+    if(!IsPoolExhausted(vk_result)) {
+      return VkResultToMGPUResult(vk_result);
+    }
+  }
+
+  Result<VkDescriptorPool> vk_descriptor_pool_result = m_pool_sizer.CreatePool(m_vk_device, 0, k_pool_set_count, descriptor_counts);
+  MGPU_FORWARD_ERROR(vk_descriptor_pool_result.Code());
+
+  m_vk_descriptor_pools.push_back(vk_descriptor_pool_result.Unwrap());
+  MGPU_VK_FORWARD_ERROR(AllocateDescriptorSet(m_vk_device, m_vk_descriptor_pools[m_current_pool], vk_descriptor_set_layout, vk_descriptor_set));
+  return vk_descriptor_set;
+}
+
+MGPUResult TransientDescriptorAllocator::Reset() {
+  // Pools past the current one have not been allocated from since the last reset.
+  const size_t used_pool_count = std::min(m_current_pool + 1u, m_vk_descriptor_pools.size());
+  for(size_t i = 0u; i < used_pool_count; i++) {
+    MGPU_VK_FORWARD_ERROR(vkResetDescriptorPool(m_vk_device, m_vk_descriptor_pools[i], 0));
+  }
+  m_current_pool = 0u;
+  return MGPU_SUCCESS;
+}
+
+} // namespace mgpu::vulkan
@@ -0,0 +1,112 @@
+
+#pragma once
+
+#include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "common/result.hpp"
+
+namespace mgpu::vulkan {
+
+// Indexed by VkDescriptorType. Covers all core descriptor types, which are numbered contiguously.
+using DescriptorCounts = std::array<u32, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT + 1u>;
+
+/**
+ * Tracks the number of descriptor sets and descriptors of each type that have been requested,
+ * so that new descriptor pools can be sized after them.
+ */
+class DescriptorPoolSizer {
+  public:
+    void Record(const DescriptorCounts& descriptor_counts);
+
+    /// Sizes the pool after the average descriptor set, but always leaves room for a set with the given descriptor counts.
+    Result<VkDescriptorPool> CreatePool(VkDevice vk_device, VkDescriptorPoolCreateFlags vk_flags, u32 max_sets, const DescriptorCounts& descriptor_counts) const;
+
+  private:
+    u64 m_requested_set_count{};
+    std::array<u64, std::tuple_size_v<DescriptorCounts>> m_requested_descriptor_counts{};
+};
+
+/**
+ * Allocates the descriptor sets of all resource sets of a device.
+ * Descriptor pools are chained: once a pool is exhausted a new, larger pool is created, which is sized after the descriptor types
+ * that have been requested so far. Freed descriptor sets are kept per layout and handed out again for the same layout,
+ * so that churn does not fragment the pools. Sets are only given back to their pool once their layout is gone,
+ * after which the pool is allocated from again.
+ */
+class DescriptorAllocator : atom::NonCopyable, atom::NonMoveable {
+  public:
+    struct Allocation {
+      VkDescriptorPool vk_descriptor_pool;
+      VkDescriptorSet vk_descriptor_set;
+    };
+
+    /**
+     * Identifies a registered layout. Unlike the VkDescriptorSetLayout handle, keys are never reused,
+     * so that a descriptor set which is freed after its layout has been released cannot end up in the free list of a newer layout.
+     */
+    using LayoutKey = u64;
+
+    explicit DescriptorAllocator(VkDevice vk_device);
+   ~DescriptorAllocator();
+
+    /// Must be called when a layout is created, before any descriptor set is allocated with it.
+    LayoutKey RegisterLayout();
+
+    /// Must be called once the layout is no longer in use, before it is destroyed. Frees all descriptor sets kept for reuse with it.
+    void ReleaseLayout(LayoutKey layout_key);
+
+    Result<Allocation> Allocate(LayoutKey layout_key, VkDescriptorSetLayout vk_descriptor_set_layout, const DescriptorCounts& descriptor_counts);
+
+    /// Must only be called once the GPU has finished using the descriptor set.
+    void Free(LayoutKey layout_key, const Allocation& allocation);
+
+  private:
+    static constexpr u32 k_initial_pool_set_count = 256u;
+    static constexpr u32 k_max_pool_set_count = 8192u;
+
+    struct DescriptorPool {
+      VkDescriptorPool vk_descriptor_pool;
+      bool may_have_space; // Cleared once the pool is exhausted, set again when descriptor sets are freed back to it.
+    };
+
+    void FreeDescriptorSet(const Allocation& allocation);
+
+    VkDevice m_vk_device;
+    std::mutex m_mutex{};
+    std::vector<DescriptorPool> m_descriptor_pools{};
+    std::unordered_map<LayoutKey, std::vector<Allocation>> m_free_allocations{};
+    LayoutKey m_next_layout_key{};
+    DescriptorPoolSizer m_pool_sizer{};
+};
+
+/**
+ * Allocates descriptor sets which only live until the command buffer they were allocated for has completed.
+ * Instead of freeing sets individually, all pools are reset at once and then reused.
+ */
+class TransientDescriptorAllocator : atom::NonCopyable, atom::NonMoveable {
+  public:
+    explicit TransientDescriptorAllocator(VkDevice vk_device);
+   ~TransientDescriptorAllocator();
+
+    Result<VkDescriptorSet> Allocate(VkDescriptorSetLayout vk_descriptor_set_layout, const DescriptorCounts& descriptor_counts);
+
+    /// Frees all descriptor sets. Must only be called once the GPU has finished using them.
+    MGPUResult Reset();
+
+  private:
+    static constexpr u32 k_pool_set_count = 1024u;
+
+    VkDevice m_vk_device;
+    std::vector<VkDescriptorPool> m_vk_descriptor_pools{};
+    size_t m_current_pool{};
+    DescriptorPoolSizer m_pool_sizer{};
+};
+
+} // namespace mgpu::vulkan
@@ -2,6 +2,7 @@
 #define VMA_IMPLEMENTATION
 
 #include <atom/float.hpp>
+#include <algorithm>
 
 #include "pipeline_state/color_blend_state.hpp"
 #include "pipeline_state/depth_stencil_state.hpp"
@@ -11,6 +12,7 @@
 #include "pipeline_state/shader_program.hpp"
 #include "pipeline_state/vertex_input_state.hpp"
 #include "buffer.hpp"
+#include "command_bundle.hpp"
 #include "device.hpp"
 #include "resource_set_layout.hpp"
 #include "resource_set.hpp"
@@ -27,6 +29,12 @@ Device::Device(
   std::shared_ptr<DeleterQueue> deleter_queue,
   Queues&& queues,
   std::shared_ptr<RenderPassCache> render_pass_cache,
+  std::shared_ptr<FramebufferCache> framebuffer_cache,
+  std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache,
+  std::shared_ptr<ComputePipelineCache> compute_pipeline_cache,
+  bool use_dynamic_rendering,
+  std::unique_ptr<PipelineCache> pipeline_cache,
+  std::unique_ptr<PipelineCompiler> pipeline_compiler,
   const MGPUPhysicalDeviceLimits& limits
 )   : DeviceBase{limits}
     , m_vk_device{vk_device}
@@ -34,7 +42,14 @@ Device::Device(
     , m_vk_physical_device_features{vk_physical_device_features}
     , m_deleter_queue{std::move(deleter_queue)}
     , m_queues{std::move(queues)}
-    , m_render_pass_cache{std::move(render_pass_cache)} {
+    , m_render_pass_cache{std::move(render_pass_cache)}
+    , m_framebuffer_cache{std::move(framebuffer_cache)}
+    , m_graphics_pipeline_cache{std::move(graphics_pipeline_cache)}
+    , m_compute_pipeline_cache{std::move(compute_pipeline_cache)}
+    , m_use_dynamic_rendering{use_dynamic_rendering}
+    , m_pipeline_cache{std::move(pipeline_cache)}
+    , m_pipeline_compiler{std::move(pipeline_compiler)}
+    , m_descriptor_allocator{std::make_unique<DescriptorAllocator>(vk_device)} {
   // TODO(fleroviux): rework architecture to avoid the cyclic dependency between Device and Queue
   m_queues.graphics_compute->SetDevice(this);
   if(m_queues.async_compute) {
@@ -43,9 +58,15 @@ Device::Device(
 }
 
 Device::~Device() {
-  m_queues = {};               // HACK: ensure that the queues is destroyed before the device
-  m_render_pass_cache.reset(); // HACK: ensure that render pass cache is destroyed before the device
+  m_pipeline_compiler.reset();       // HACK: ensure that all background compilations have completed before the queues are destroyed
+  m_queues = {};                     // HACK: ensure that the queues is destroyed before the device
+  m_graphics_pipeline_cache.reset(); // HACK: ensure that graphics pipeline cache is destroyed before the device
+  m_compute_pipeline_cache.reset();  // HACK: ensure that compute pipeline cache is destroyed before the device
+  m_framebuffer_cache.reset();       // HACK: ensure that framebuffer cache is destroyed before the device
+  m_render_pass_cache.reset();       // HACK: ensure that render pass cache is destroyed before the device
+  m_pipeline_cache.reset();          // HACK: ensure that the pipeline cache is destroyed (and stored) before the device
   m_deleter_queue->DrainAll();
+  m_descriptor_allocator.reset();    // HACK: the deleter queue frees descriptor sets through the allocator, so it must be drained first
 
   vkDeviceWaitIdle(m_vk_device);
   vmaDestroyAllocator(m_vma_allocator);
@@ -56,7 +77,8 @@ Result<DeviceBase*> Device::Create(
   VkInstance vk_instance,
   VulkanPhysicalDevice& vk_physical_device,
   const PhysicalDevice::QueueFamilyIndices& queue_family_indices,
-  const MGPUPhysicalDeviceLimits& limits
+  const MGPUPhysicalDeviceLimits& limits,
+  const MGPUDeviceCreateInfo& create_info
 ) {
   std::vector<const char*> vk_required_device_extensions{"VK_KHR_swapchain"};
   std::vector<const char*> vk_required_device_layers{};
@@ -103,11 +125,54 @@ Result<DeviceBase*> Device::Create(
   VkPhysicalDeviceFeatures vk_physical_device_features{};
   vkGetPhysicalDeviceFeatures(vk_physical_device.Handle(), &vk_physical_device_features);
 
+  // Queues track the progress of their submissions with timeline semaphores, so Vulkan 1.2 is required.
+  // Indirect draws may source their draw count from a buffer if drawIndirectCount is supported.
+  if(vk_physical_device.GetProperties().apiVersion < VK_API_VERSION_1_2) {
+    return MGPU_INTERNAL_ERROR;
+  }
+
+  VkPhysicalDeviceVulkan12Features vk_vulkan12_features{};
+  vk_vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+  // Dynamic rendering is core in Vulkan 1.3. It lets queues begin render passes without creating render pass and framebuffer objects.
+  VkPhysicalDeviceDynamicRenderingFeatures vk_dynamic_rendering_features{
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES,
+    .pNext = nullptr,
+    .dynamicRendering = VK_FALSE
+  };
+
+  if(vk_physical_device.GetProperties().apiVersion >= VK_API_VERSION_1_3) {
+    vk_vulkan12_features.pNext = &vk_dynamic_rendering_features;
+  }
+
+  VkPhysicalDeviceFeatures2 vk_physical_device_features2{
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+    .pNext = &vk_vulkan12_features,
+    .features = {}
+  };
+  vkGetPhysicalDeviceFeatures2(vk_physical_device.Handle(), &vk_physical_device_features2);
+
+  if(!vk_vulkan12_features.timelineSemaphore) {
+    return MGPU_INTERNAL_ERROR;
+  }
+
+  // Only enable the Vulkan 1.2 features which are actually used.
+  const VkBool32 draw_indirect_count = vk_vulkan12_features.drawIndirectCount;
+  vk_vulkan12_features = {};
+  vk_vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+  vk_vulkan12_features.pNext = vk_dynamic_rendering_features.dynamicRendering ? &vk_dynamic_rendering_features : nullptr;
+  vk_vulkan12_features.timelineSemaphore = VK_TRUE;
+  vk_vulkan12_features.drawIndirectCount = draw_indirect_count;
+
+  // The feature structures are passed on to device creation, which enables dynamic rendering if it is supported.
+  const bool use_dynamic_rendering = vk_dynamic_rendering_features.dynamicRendering == VK_TRUE;
+
   Result<VkDevice> vk_device_result = vk_physical_device.CreateLogicalDevice(
     vk_queue_create_infos,
     vk_required_device_extensions,
     vk_required_device_layers,
-    &vk_physical_device_features
+    &vk_physical_device_features,
+    &vk_vulkan12_features
   );
   MGPU_FORWARD_ERROR(vk_device_result.Code());
 
@@ -115,21 +180,46 @@ Result<DeviceBase*> Device::Create(
 
   std::shared_ptr<DeleterQueue> deleter_queue = std::make_shared<DeleterQueue>();
   std::shared_ptr<RenderPassCache> render_pass_cache = std::make_shared<RenderPassCache>(vk_device, deleter_queue);
+  std::shared_ptr<FramebufferCache> framebuffer_cache = std::make_shared<FramebufferCache>(vk_device, deleter_queue);
 
   Result<VmaAllocator> vma_allocator_result = CreateVmaAllocator(vk_instance, vk_physical_device.Handle(), vk_device);
-  MGPU_FORWARD_ERROR(vma_allocator_result.Code()); // TODO(fleroviux): this leaks memory
+  if(vma_allocator_result.Code() != MGPU_SUCCESS) {
+    vkDestroyDevice(vk_device, nullptr);
+    return vma_allocator_result.Code();
+  }
+
+  Result<std::unique_ptr<PipelineCache>> pipeline_cache_result = PipelineCache::Create(vk_device, vk_physical_device.GetProperties(), create_info);
+  if(pipeline_cache_result.Code() != MGPU_SUCCESS) {
+    vmaDestroyAllocator(vma_allocator_result.Unwrap());
+    vkDestroyDevice(vk_device, nullptr);
+    return pipeline_cache_result.Code();
+  }
+
+  std::unique_ptr<PipelineCache> pipeline_cache = pipeline_cache_result.Unwrap();
+
+  std::unique_ptr<PipelineCompiler> pipeline_compiler{};
+  if(create_info.pipeline_compiler_thread_count > 0u) {
+    pipeline_compiler = std::make_unique<PipelineCompiler>(create_info.pipeline_compiler_thread_count);
+  }
+
+  // All queues share a single graphics pipeline cache, so that a pipeline is never compiled more than once.
+  std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache = std::make_shared<GraphicsPipelineCache>(
+    vk_device, pipeline_cache->Handle(), pipeline_compiler.get(), deleter_queue, create_info.max_graphics_pipeline_count);
+  std::shared_ptr<ComputePipelineCache> compute_pipeline_cache = std::make_shared<ComputePipelineCache>(
+    vk_device, pipeline_cache->Handle(), deleter_queue);
 
   std::unique_ptr<Queue> graphics_compute_queue{};
   std::unique_ptr<Queue> async_compute_queue{};
 
+  // Deletions are tracked against the timelines of all queues, but only run by the graphics and compute queue, which renders and presents.
   Result<std::unique_ptr<Queue>> graphics_compute_queue_result = Queue::Create(
-    vk_device, queue_family_indices.graphics_and_compute.value(), deleter_queue, render_pass_cache);
+    vk_device, queue_family_indices.graphics_and_compute.value(), deleter_queue, render_pass_cache, framebuffer_cache, graphics_pipeline_cache, compute_pipeline_cache, use_dynamic_rendering, true);
   MGPU_FORWARD_ERROR(graphics_compute_queue_result.Code()); // TODO(fleroviux): this leaks memory
   graphics_compute_queue = graphics_compute_queue_result.Unwrap();
 
   if(queue_family_indices.dedicated_compute.has_value()) {
     Result<std::unique_ptr<Queue>> async_compute_queue_result = Queue::Create(
-      vk_device, queue_family_indices.dedicated_compute.value(), deleter_queue, render_pass_cache);
+      vk_device, queue_family_indices.dedicated_compute.value(), deleter_queue, render_pass_cache, framebuffer_cache, graphics_pipeline_cache, compute_pipeline_cache, use_dynamic_rendering, false);
     MGPU_FORWARD_ERROR(async_compute_queue_result.Code()); // TODO(fleroviux): this leaks memory
     async_compute_queue = async_compute_queue_result.Unwrap();
   }
@@ -141,6 +231,12 @@ Result<DeviceBase*> Device::Create(
     deleter_queue,
     Queues{std::move(graphics_compute_queue), std::move(async_compute_queue)},
     render_pass_cache,
+    std::move(framebuffer_cache),
+    std::move(graphics_pipeline_cache),
+    std::move(compute_pipeline_cache),
+    use_dynamic_rendering,
+    std::move(pipeline_cache),
+    std::move(pipeline_compiler),
     limits
   };
 }
@@ -167,6 +263,31 @@ Result<VmaAllocator> Device::CreateVmaAllocator(VkInstance vk_instance, VkPhysic
   return vma_allocator;
 }
 
+void Device::WaitForPipelineCompilations() {
+  if(m_pipeline_compiler) {
+    m_pipeline_compiler->WaitIdle();
+  }
+}
+
+void Device::DiscardPendingUploads(const Buffer* buffer) {
+  // The queues may already be null while they are being destroyed.
+  if(m_queues.graphics_compute) {
+    m_queues.graphics_compute->DiscardPendingUploads(buffer);
+  }
+  if(m_queues.async_compute) {
+    m_queues.async_compute->DiscardPendingUploads(buffer);
+  }
+}
+
+void Device::DiscardPendingUploads(const Texture* texture) {
+  if(m_queues.graphics_compute) {
+    m_queues.graphics_compute->DiscardPendingUploads(texture);
+  }
+  if(m_queues.async_compute) {
+    m_queues.async_compute->DiscardPendingUploads(texture);
+  }
+}
+
 QueueBase* Device::GetQueue(MGPUQueueType queue_type) {
   switch(queue_type) {
     case MGPU_QUEUE_TYPE_GRAPHICS_COMPUTE: return m_queues.graphics_compute.get();
@@ -208,28 +329,101 @@ Result<ShaderProgramBase*> Device::CreateShaderProgram(const MGPUShaderProgramCr
   return ShaderProgram::Create(this, create_info);
 }
 
-Result<RasterizerStateBase*> Device::CreateRasterizerState(const MGPURasterizerStateCreateInfo& create_info) {
-  return new RasterizerState{create_info};
+// Pipeline states invalidate the pipelines created from them on destruction. Since the states which are still alive
+// are destroyed by DeviceBase, after the graphics pipeline cache, they only hold a weak reference to the cache.
+Result<RasterizerStateBase*> Device::CreateRasterizerStateImpl(const MGPURasterizerStateCreateInfo& create_info) {
+  return new RasterizerState{create_info, m_graphics_pipeline_cache};
 }
 
-Result<InputAssemblyStateBase*> Device::CreateInputAssemblyState(const MGPUInputAssemblyStateCreateInfo& create_info) {
-  return new InputAssemblyState{create_info};
+Result<InputAssemblyStateBase*> Device::CreateInputAssemblyStateImpl(const MGPUInputAssemblyStateCreateInfo& create_info) {
+  return new InputAssemblyState{create_info, m_graphics_pipeline_cache};
 }
 
-Result<ColorBlendStateBase*> Device::CreateColorBlendState(const MGPUColorBlendStateCreateInfo& create_info) {
-  return new ColorBlendState{create_info};
+Result<ColorBlendStateBase*> Device::CreateColorBlendStateImpl(const MGPUColorBlendStateCreateInfo& create_info) {
+  return new ColorBlendState{create_info, m_graphics_pipeline_cache};
 }
 
-Result<VertexInputStateBase*> Device::CreateVertexInputState(const MGPUVertexInputStateCreateInfo& create_info) {
-  return new VertexInputState{create_info};
+Result<VertexInputStateBase*> Device::CreateVertexInputStateImpl(const MGPUVertexInputStateCreateInfo& create_info) {
+  return new VertexInputState{create_info, m_graphics_pipeline_cache};
 }
 
-Result<DepthStencilStateBase*> Device::CreateDepthStencilState(const MGPUDepthStencilStateCreateInfo& create_info) {
-  return new DepthStencilState{create_info};
+Result<DepthStencilStateBase*> Device::CreateDepthStencilStateImpl(const MGPUDepthStencilStateCreateInfo& create_info) {
+  return new DepthStencilState{create_info, m_graphics_pipeline_cache};
 }
 
 Result<SwapChainBase*> Device::CreateSwapChain(const MGPUSwapChainCreateInfo& create_info) {
   return SwapChain::Create(this, create_info);
 }
 
+Result<CommandBundleBase*> Device::CreateCommandBundle(const CommandList* command_list) {
+  return CommandBundle::Create(this, command_list);
+}
+
+Result<std::vector<u8>> Device::GetPipelineCacheData() {
+  return m_pipeline_cache->GetData();
+}
+
+void Device::SetFallbackShaderProgram(ShaderProgramBase* shader_program) {
+  m_fallback_shader_program = (ShaderProgram*)shader_program;
+}
+
+u32 Device::GetPendingPipelineCompilationCount() const {
+  if(m_pipeline_compiler) {
+    return m_pipeline_compiler->GetPendingJobCount();
+  }
+  return 0u;
+}
+
+MGPUResult Device::PrecompileGraphicsPipelines(std::span<const MGPUGraphicsPipelineInfo> pipeline_infos) {
+  std::vector<GraphicsPipelineQuery> queries{};
+  queries.reserve(pipeline_infos.size());
+
+  for(const MGPUGraphicsPipelineInfo& pipeline_info : pipeline_infos) {
+    const MGPURenderPassInfo& render_pass_info = pipeline_info.render_pass;
+
+    RenderPassQuery render_pass_query{};
+
+    for(size_t i = 0; i < render_pass_info.color_attachment_count; i++) {
+      const MGPURenderPassColorAttachmentInfo& color_attachment = render_pass_info.color_attachments[i];
+      render_pass_query.SetColorAttachment(i, color_attachment.format, color_attachment.load_op, color_attachment.store_op);
+    }
+
+    if(render_pass_info.depth_stencil_attachment != nullptr) {
+      const MGPURenderPassDepthStencilAttachmentInfo& depth_stencil_attachment = *render_pass_info.depth_stencil_attachment;
+      render_pass_query.SetDepthStencilAttachment(
+        depth_stencil_attachment.format,
+        depth_stencil_attachment.depth_load_op, depth_stencil_attachment.depth_store_op,
+        depth_stencil_attachment.stencil_load_op, depth_stencil_attachment.stencil_store_op);
+    }
+
+    GraphicsPipelineQuery query{
+      .m_shader_program = (const ShaderProgram*)pipeline_info.shader_program,
+      .m_rasterizer_state = (const RasterizerState*)pipeline_info.rasterizer_state,
+      .m_input_assembly_state = (const InputAssemblyState*)pipeline_info.input_assembly_state,
+      .m_color_blend_state = (const ColorBlendState*)pipeline_info.color_blend_state,
+      .m_vertex_input_state = (const VertexInputState*)pipeline_info.vertex_input_state,
+      .m_depth_stencil_state = (const DepthStencilState*)pipeline_info.depth_stencil_state
+    };
+
+    // Must match the queries that queues create when beginning a render pass.
+    if(m_use_dynamic_rendering) {
+      query.m_render_target_formats = render_pass_query.GetRenderTargetFormats();
+    } else {
+      Result<VkRenderPass> vk_render_pass_result = m_render_pass_cache->GetCompatibleRenderPass(render_pass_query);
+      MGPU_FORWARD_ERROR(vk_render_pass_result.Code());
+      query.m_vk_render_pass = vk_render_pass_result.Unwrap();
+    }
+
+    queries.push_back(query);
+  }
+
+  // Use all cores, even if background compilation has not been enabled for this device.
+  if(m_pipeline_compiler) {
+    return m_graphics_pipeline_cache->Precompile(queries, *m_pipeline_compiler);
+  }
+
+  PipelineCompiler pipeline_compiler{std::max(std::thread::hardware_concurrency(), 1u)};
+  return m_graphics_pipeline_cache->Precompile(queries, pipeline_compiler);
+}
+
 }  // namespace mgpu::vulkan
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <atom/integer.hpp>
+#include <atomic>
 #include <optional>
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
@@ -10,7 +11,13 @@
 #include "backend/device.hpp"
 #include "common/result.hpp"
 #include "queue.hpp"
+#include "compute_pipeline_cache.hpp"
 #include "deleter_queue.hpp"
+#include "descriptor_allocator.hpp"
+#include "framebuffer_cache.hpp"
+#include "graphics_pipeline_cache.hpp"
+#include "pipeline_cache.hpp"
+#include "pipeline_compiler.hpp"
 #include "render_pass_cache.hpp"
 #include "physical_device.hpp"
 
@@ -29,15 +36,26 @@ class Device final : public DeviceBase {
       VkInstance vk_instance,
       VulkanPhysicalDevice& vk_physical_device,
       const PhysicalDevice::QueueFamilyIndices& queue_family_indices,
-      const MGPUPhysicalDeviceLimits& limits
+      const MGPUPhysicalDeviceLimits& limits,
+      const MGPUDeviceCreateInfo& create_info
     );
 
     [[nodiscard]] VkDevice Handle() { return m_vk_device; }
     [[nodiscard]] VmaAllocator GetVmaAllocator() { return m_vma_allocator; }
     [[nodiscard]] const VkPhysicalDeviceFeatures& GetVkPhysicalDeviceFeatures() const { return m_vk_physical_device_features; }
     [[nodiscard]] DeleterQueue& GetDeleterQueue() { return *m_deleter_queue; }
+    [[nodiscard]] FramebufferCache& GetFramebufferCache() { return *m_framebuffer_cache; }
+    [[nodiscard]] GraphicsPipelineCache& GetGraphicsPipelineCache() { return *m_graphics_pipeline_cache; }
+    [[nodiscard]] ComputePipelineCache& GetComputePipelineCache() { return *m_compute_pipeline_cache; }
+    [[nodiscard]] DescriptorAllocator& GetDescriptorAllocator() { return *m_descriptor_allocator; }
     [[nodiscard]] Queue& GetCommandQueue() { return *m_queues.graphics_compute; } // TODO: remove this
 
+    [[nodiscard]] ShaderProgram* GetFallbackShaderProgram() { return m_fallback_shader_program; }
+    void WaitForPipelineCompilations();
+
+    void DiscardPendingUploads(const Buffer* buffer);
+    void DiscardPendingUploads(const Texture* texture);
+
     QueueBase* GetQueue(MGPUQueueType queue_type) override;
     Result<BufferBase*> CreateBuffer(const MGPUBufferCreateInfo& create_info) override;
     Result<TextureBase*> CreateTexture(const MGPUTextureCreateInfo& create_info) override;
@@ -46,12 +64,19 @@ class Device final : public DeviceBase {
     Result<ResourceSetBase*> CreateResourceSet(const MGPUResourceSetCreateInfo& create_info) override;
     Result<ShaderModuleBase*> CreateShaderModule(const u32* spirv_code, size_t spirv_byte_size) override;
     Result<ShaderProgramBase*> CreateShaderProgram(const MGPUShaderProgramCreateInfo& create_info) override;
-    Result<RasterizerStateBase*> CreateRasterizerState(const MGPURasterizerStateCreateInfo& create_info) override;
-    Result<InputAssemblyStateBase*> CreateInputAssemblyState(const MGPUInputAssemblyStateCreateInfo& create_info) override;
-    Result<ColorBlendStateBase*> CreateColorBlendState(const MGPUColorBlendStateCreateInfo& create_info) override;
-    Result<VertexInputStateBase*> CreateVertexInputState(const MGPUVertexInputStateCreateInfo& create_info) override;
-    Result<DepthStencilStateBase*> CreateDepthStencilState(const MGPUDepthStencilStateCreateInfo& create_info) override;
     Result<SwapChainBase*> CreateSwapChain(const MGPUSwapChainCreateInfo& create_info) override;
+    Result<CommandBundleBase*> CreateCommandBundle(const CommandList* command_list) override;
+    Result<std::vector<u8>> GetPipelineCacheData() override;
+    void SetFallbackShaderProgram(ShaderProgramBase* shader_program) override;
+    [[nodiscard]] u32 GetPendingPipelineCompilationCount() const override;
+    MGPUResult PrecompileGraphicsPipelines(std::span<const MGPUGraphicsPipelineInfo> pipeline_infos) override;
+
+  protected:
+    Result<RasterizerStateBase*> CreateRasterizerStateImpl(const MGPURasterizerStateCreateInfo& create_info) override;
+    Result<InputAssemblyStateBase*> CreateInputAssemblyStateImpl(const MGPUInputAssemblyStateCreateInfo& create_info) override;
+    Result<ColorBlendStateBase*> CreateColorBlendStateImpl(const MGPUColorBlendStateCreateInfo& create_info) override;
+    Result<VertexInputStateBase*> CreateVertexInputStateImpl(const MGPUVertexInputStateCreateInfo& create_info) override;
+    Result<DepthStencilStateBase*> CreateDepthStencilStateImpl(const MGPUDepthStencilStateCreateInfo& create_info) override;
 
   private:
     Device(
@@ -61,6 +86,12 @@ class Device final : public DeviceBase {
       std::shared_ptr<DeleterQueue> deleter_queue,
       Queues&& queues,
       std::shared_ptr<RenderPassCache> render_pass_cache,
+      std::shared_ptr<FramebufferCache> framebuffer_cache,
+      std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache,
+      std::shared_ptr<ComputePipelineCache> compute_pipeline_cache,
+      bool use_dynamic_rendering,
+      std::unique_ptr<PipelineCache> pipeline_cache,
+      std::unique_ptr<PipelineCompiler> pipeline_compiler,
       const MGPUPhysicalDeviceLimits& limits
     );
 
@@ -72,6 +103,14 @@ class Device final : public DeviceBase {
     std::shared_ptr<DeleterQueue> m_deleter_queue;
     Queues m_queues;
     std::shared_ptr<RenderPassCache> m_render_pass_cache;
+    std::shared_ptr<FramebufferCache> m_framebuffer_cache;
+    std::shared_ptr<GraphicsPipelineCache> m_graphics_pipeline_cache;
+    std::shared_ptr<ComputePipelineCache> m_compute_pipeline_cache;
+    bool m_use_dynamic_rendering;
+    std::unique_ptr<PipelineCache> m_pipeline_cache;
+    std::unique_ptr<PipelineCompiler> m_pipeline_compiler;
+    std::atomic<ShaderProgram*> m_fallback_shader_program{};
+    std::unique_ptr<DescriptorAllocator> m_descriptor_allocator;
 };
 
 }  // namespace mgpu::vulkan
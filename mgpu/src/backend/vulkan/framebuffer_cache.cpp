@@ -0,0 +1,110 @@
+
+#include <atom/hash.hpp>
+#include <algorithm>
+
+#include "backend/vulkan/lib/vulkan_result.hpp"
+#include "framebuffer_cache.hpp"
+
+namespace mgpu::vulkan {
+
+size_t FramebufferQuery::Hasher::operator()(const FramebufferQuery& query) const {
+  size_t hash = std::hash<VkRenderPass>{}(query.m_vk_render_pass);
+  for(VkImageView vk_image_view : query.m_vk_image_views) {
+    atom::hash_combine(hash, vk_image_view);
+  }
+  atom::hash_combine(hash, query.m_width);
+  atom::hash_combine(hash, query.m_height);
+  return hash;
+}
+
+bool FramebufferQuery::operator==(const FramebufferQuery& other_query) const {
+  return m_vk_render_pass == other_query.m_vk_render_pass
+      && m_width == other_query.m_width
+      && m_height == other_query.m_height
+      && std::equal(m_vk_image_views.begin(), m_vk_image_views.end(), other_query.m_vk_image_views.begin(), other_query.m_vk_image_views.end());
+}
+
+FramebufferCache::FramebufferCache(VkDevice vk_device, std::shared_ptr<DeleterQueue> deleter_queue)
+    : m_vk_device{vk_device}
+    , m_deleter_queue{std::move(deleter_queue)} {
+}
+
+FramebufferCache::~FramebufferCache() {
+  m_query_to_vk_framebuffer.ForEach([&](const FramebufferQuery&, VkFramebuffer vk_framebuffer) {
+    DestroyFramebuffer(vk_framebuffer);
+  });
+}
+
+Result<VkFramebuffer> FramebufferCache::GetFramebuffer(const FramebufferQuery& query) {
+  const size_t query_hash = FramebufferQuery::Hasher{}(query);
+
+  // The cache is shared by all queues, which may record command lists on different threads.
+  std::lock_guard lock_guard{m_mutex};
+
+  if(const VkFramebuffer* vk_framebuffer = m_query_to_vk_framebuffer.Find(query, query_hash); vk_framebuffer != nullptr) {
+    return *vk_framebuffer;
+  }
+
+  const VkFramebufferCreateInfo vk_framebuffer_create_info{
+    .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+    .pNext = nullptr,
+    .flags = 0,
+    .renderPass = query.m_vk_render_pass,
+    .attachmentCount = (u32)query.m_vk_image_views.Size(),
+    .pAttachments = query.m_vk_image_views.Data(),
+    .width = query.m_width,
+    .height = query.m_height,
+    .layers = 1u
+  };
+
+  VkFramebuffer vk_framebuffer{};
+  MGPU_VK_FORWARD_ERROR(vkCreateFramebuffer(m_vk_device, &vk_framebuffer_create_info, nullptr, &vk_framebuffer));
+
+  *m_query_to_vk_framebuffer.TryEmplace(query, query_hash).first = vk_framebuffer;
+  for(VkImageView vk_image_view : query.m_vk_image_views) {
+    m_vk_image_view_to_queries[vk_image_view].push_back(query);
+  }
+  return vk_framebuffer;
+}
+
+void FramebufferCache::Invalidate(VkImageView vk_image_view) {
+  std::lock_guard lock_guard{m_mutex};
+
+  const auto match = m_vk_image_view_to_queries.find(vk_image_view);
+  if(match == m_vk_image_view_to_queries.end()) {
+    return;
+  }
+
+  const std::vector<FramebufferQuery> queries = std::move(match->second);
+  m_vk_image_view_to_queries.erase(match);
+
+  for(const FramebufferQuery& query : queries) {
+    const size_t query_hash = FramebufferQuery::Hasher{}(query);
+
+    if(const VkFramebuffer* vk_framebuffer = m_query_to_vk_framebuffer.Find(query, query_hash); vk_framebuffer != nullptr) {
+      DestroyFramebuffer(*vk_framebuffer);
+      m_query_to_vk_framebuffer.Erase(query, query_hash);
+    }
+
+    // Forget about the framebuffer in the other image views that it references, too.
+    for(VkImageView other_vk_image_view : query.m_vk_image_views) {
+      const auto other_match = m_vk_image_view_to_queries.find(other_vk_image_view);
+      if(other_match != m_vk_image_view_to_queries.end()) {
+        std::erase(other_match->second, query);
+        if(other_match->second.empty()) {
+          m_vk_image_view_to_queries.erase(other_match);
+        }
+      }
+    }
+  }
+}
+
+void FramebufferCache::DestroyFramebuffer(VkFramebuffer vk_framebuffer) {
+  // Defer deletion of underlying Vulkan resources until the currently recorded frame has been fully processed on the GPU.
+  VkDevice vk_device = m_vk_device;
+  m_deleter_queue->Schedule([vk_device, vk_framebuffer]() {
+    vkDestroyFramebuffer(vk_device, vk_framebuffer, nullptr);
+  });
+}
+
+} // namespace mgpu::vulkan
@@ -0,0 +1,59 @@
+
+#pragma once
+
+#include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <atom/vector_n.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "common/flat_hash_map.hpp"
+#include "common/limits.hpp"
+#include "common/result.hpp"
+#include "deleter_queue.hpp"
+
+namespace mgpu::vulkan {
+
+struct FramebufferQuery {
+  struct Hasher {
+    size_t operator()(const FramebufferQuery& query) const;
+  };
+
+  // Framebuffers only need to be compatible with the render passes that they are used with, so this should be a compatible render pass.
+  VkRenderPass m_vk_render_pass{};
+  atom::Vector_N<VkImageView, limits::max_total_attachments> m_vk_image_views{};
+  u32 m_width{};
+  u32 m_height{};
+
+  [[nodiscard]] bool operator==(const FramebufferQuery& other_query) const;
+};
+
+/**
+ * Caches framebuffers for all queues of a device, so that beginning a render pass does not create a new framebuffer every time.
+ * Framebuffers are destroyed when any of the image views that they reference is destroyed.
+ */
+class FramebufferCache : atom::NonCopyable, atom::NonMoveable {
+  public:
+    FramebufferCache(VkDevice vk_device, std::shared_ptr<DeleterQueue> deleter_queue);
+   ~FramebufferCache();
+
+    Result<VkFramebuffer> GetFramebuffer(const FramebufferQuery& query);
+
+    /// Destroys all framebuffers which reference the image view. Must be called before the image view is destroyed.
+    void Invalidate(VkImageView vk_image_view);
+
+  private:
+    void DestroyFramebuffer(VkFramebuffer vk_framebuffer);
+
+    VkDevice m_vk_device;
+    std::shared_ptr<DeleterQueue> m_deleter_queue;
+    std::mutex m_mutex{};
+    FlatHashMap<FramebufferQuery, VkFramebuffer> m_query_to_vk_framebuffer{};
+    std::unordered_map<VkImageView, std::vector<FramebufferQuery>> m_vk_image_view_to_queries{};
+};
+
+} // namespace mgpu::vulkan
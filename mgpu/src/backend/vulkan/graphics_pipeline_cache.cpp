@@ -1,6 +1,9 @@
 
 #include <atom/hash.hpp>
 #include <atom/integer.hpp>
+#include <algorithm>
+#include <array>
+#include <utility>
 
 #include "backend/vulkan/lib/vulkan_result.hpp"
 #include "pipeline_state/color_blend_state.hpp"
@@ -13,6 +16,18 @@
 
 namespace mgpu::vulkan {
 
+// Returns all shader programs and pipeline states that a pipeline for the query is created from.
+static std::array<const void*, 6> GetStates(const GraphicsPipelineQuery& query) {
+  return {
+    query.m_shader_program,
+    query.m_rasterizer_state,
+    query.m_input_assembly_state,
+    query.m_color_blend_state,
+    query.m_vertex_input_state,
+    query.m_depth_stencil_state
+  };
+}
+
 size_t GraphicsPipelineQuery::Hasher::operator()(const GraphicsPipelineQuery& query) const {
   size_t hash = std::hash<const ShaderProgram*>{}(query.m_shader_program);
   atom::hash_combine(hash, query.m_rasterizer_state);
@@ -21,6 +36,14 @@ size_t GraphicsPipelineQuery::Hasher::operator()(const GraphicsPipelineQuery& qu
   atom::hash_combine(hash, query.m_vertex_input_state);
   atom::hash_combine(hash, query.m_depth_stencil_state);
   atom::hash_combine(hash, query.m_vk_render_pass);
+
+  const RenderTargetFormats& render_target_formats = query.m_render_target_formats;
+  atom::hash_combine(hash, render_target_formats.m_color_attachment_set);
+  for(VkFormat vk_format : render_target_formats.m_vk_color_attachment_formats) {
+    atom::hash_combine(hash, vk_format);
+  }
+  atom::hash_combine(hash, render_target_formats.m_vk_depth_format);
+  atom::hash_combine(hash, render_target_formats.m_vk_stencil_format);
   return hash;
 }
 
@@ -31,33 +54,342 @@ bool GraphicsPipelineQuery::operator==(const GraphicsPipelineQuery& other_query)
       && m_color_blend_state == other_query.m_color_blend_state
       && m_vertex_input_state == other_query.m_vertex_input_state
       && m_depth_stencil_state == other_query.m_depth_stencil_state
-      && m_vk_render_pass == other_query.m_vk_render_pass;
+      && m_vk_render_pass == other_query.m_vk_render_pass
+      && m_render_target_formats == other_query.m_render_target_formats;
 }
 
-GraphicsPipelineCache::GraphicsPipelineCache(VkDevice vk_device, std::shared_ptr<DeleterQueue> deleter_queue)
-    : m_vk_device{vk_device}
-    , m_deleter_queue{std::move(deleter_queue)} {
+GraphicsPipelineCache::GraphicsPipelineCache(
+  VkDevice vk_device,
+  VkPipelineCache vk_pipeline_cache,
+  PipelineCompiler* pipeline_compiler,
+  std::shared_ptr<DeleterQueue> deleter_queue,
+  u32 max_pipeline_count
+)   : m_vk_device{vk_device}
+    , m_vk_pipeline_cache{vk_pipeline_cache}
+    , m_pipeline_compiler{pipeline_compiler}
+    , m_deleter_queue{std::move(deleter_queue)}
+    , m_max_pipeline_count{max_pipeline_count} {
 }
 
 GraphicsPipelineCache::~GraphicsPipelineCache() {
-  for(const auto& [query_key, vk_pipeline] : m_query_to_vk_pipeline) {
+  // The device stops the pipeline compiler before destroying the cache, so all asynchronous compilations have completed by now.
+  for(const Shard& shard : m_shards) {
+    shard.query_to_pipeline.ForEach([&](const GraphicsPipelineQuery&, const std::shared_ptr<CachedPipeline>& cached_pipeline) {
+      if(cached_pipeline->vk_pipeline == VK_NULL_HANDLE) {
+        return;
+      }
+
+      // Defer deletion of underlying Vulkan resources until the currently recorded frame has been fully processed on the GPU.
+      VkDevice vk_device = m_vk_device;
+      VkPipeline vk_pipeline = cached_pipeline->vk_pipeline;
+      m_deleter_queue->Schedule([vk_device, vk_pipeline]() {
+        vkDestroyPipeline(vk_device, vk_pipeline, nullptr);
+      });
+    });
+  }
+}
+
+Result<VkPipeline> GraphicsPipelineCache::GetPipeline(const GraphicsPipelineQuery& query, size_t query_hash, bool wait, PipelinePin* pin) {
+  Shard& shard = GetShard(query_hash);
+
+  // Fast path: the pipeline has been compiled already, which only requires a shared lock on the shard.
+  {
+    std::shared_lock lock{shard.mutex};
+
+    const std::shared_ptr<CachedPipeline>* match = std::as_const(shard.query_to_pipeline).Find(query, query_hash);
+    if(match != nullptr) {
+      CachedPipeline& cached_pipeline = **match;
+      if(cached_pipeline.done.load(std::memory_order_acquire) && cached_pipeline.vk_result == VK_SUCCESS) {
+        MarkUsed(cached_pipeline);
+        // Pinning under the shard lock guarantees that the pipeline has not been evicted in the meantime.
+        if(pin != nullptr) {
+          *pin = Pin(*match);
+        }
+        return cached_pipeline.vk_pipeline;
+      }
+    }
+  }
+
+  bool inserted{};
+  const std::shared_ptr<CachedPipeline> cached_pipeline = FindOrInsert(shard, query, query_hash, inserted);
+  MarkUsed(*cached_pipeline);
+
+  // Without a pipeline compiler, pipelines are never skipped, even if another thread or Precompile() is compiling them.
+  const bool may_skip = !wait && m_pipeline_compiler != nullptr;
+
+  // Only the thread which inserted the pipeline compiles it. Everyone else waits for that compilation to complete.
+  if(inserted) {
+    EvictLeastRecentlyUsed();
+
+    if(!may_skip) {
+      CompilePipeline(query, cached_pipeline);
+    } else {
+      EnqueuePipeline(query, cached_pipeline, *m_pipeline_compiler);
+      return MGPU_NOT_READY;
+    }
+  }
+
+  if(!cached_pipeline->done.load(std::memory_order_acquire)) {
+    if(may_skip) {
+      return MGPU_NOT_READY;
+    }
+    cached_pipeline->done.wait(false, std::memory_order_acquire);
+  }
+
+  Result<VkPipeline> vk_pipeline_result = GetCompletedPipeline(cached_pipeline);
+
+  // The pipeline may have been evicted since it was inserted, so take the pin on the fast path, which looks the pipeline up again.
+  if(pin != nullptr && vk_pipeline_result.Code() == MGPU_SUCCESS) {
+    return GetPipeline(query, query_hash, wait, pin);
+  }
+  return vk_pipeline_result;
+}
+
+MGPUResult GraphicsPipelineCache::Precompile(std::span<const GraphicsPipelineQuery> queries, PipelineCompiler& pipeline_compiler) {
+  std::vector<std::shared_ptr<CachedPipeline>> cached_pipelines{};
+  cached_pipelines.reserve(queries.size());
+
+  for(const GraphicsPipelineQuery& query : queries) {
+    const size_t query_hash = GraphicsPipelineQuery::Hasher{}(query);
+
+    bool inserted{};
+    cached_pipelines.push_back(FindOrInsert(GetShard(query_hash), query, query_hash, inserted));
+    MarkUsed(*cached_pipelines.back());
+
+    if(inserted) {
+      EnqueuePipeline(query, cached_pipelines.back(), pipeline_compiler);
+    }
+  }
+
+  // Wait for all pipelines, including those which are being compiled because of draws or by other threads.
+  MGPUResult result = MGPU_SUCCESS;
+
+  for(const std::shared_ptr<CachedPipeline>& cached_pipeline : cached_pipelines) {
+    cached_pipeline->done.wait(false, std::memory_order_acquire);
+
+    const MGPUResult pipeline_result = GetCompletedPipeline(cached_pipeline).Code();
+    if(result == MGPU_SUCCESS) {
+      result = pipeline_result;
+    }
+  }
+
+  EvictLeastRecentlyUsed();
+  return result;
+}
+
+void GraphicsPipelineCache::Invalidate(const void* state) {
+  std::unordered_set<std::shared_ptr<CachedPipeline>> cached_pipelines{};
+  {
+    std::lock_guard lock_guard{m_dependency_mutex};
+
+    const auto match = m_state_to_pipelines.find(state);
+    if(match == m_state_to_pipelines.end()) {
+      return;
+    }
+    cached_pipelines = std::move(match->second);
+    m_state_to_pipelines.erase(match);
+  }
+
+  for(const std::shared_ptr<CachedPipeline>& cached_pipeline : cached_pipelines) {
+    // The pipeline may still be compiled in the background, in which case we have to wait for the result to destroy it.
+    cached_pipeline->done.wait(false, std::memory_order_acquire);
+    Retire(cached_pipeline);
+  }
+}
+
+GraphicsPipelineCache::Shard& GraphicsPipelineCache::GetShard(size_t query_hash) {
+  // Use the upper bits of the (mixed) hash, so that the hash map of each shard still sees well distributed lower bits.
+  const u64 hash = (u64)query_hash * 0x9E3779B97F4A7C15ull;
+  return m_shards[hash >> (64 - k_shard_bits)];
+}
+
+std::shared_ptr<GraphicsPipelineCache::CachedPipeline> GraphicsPipelineCache::FindOrInsert(Shard& shard, const GraphicsPipelineQuery& query, size_t query_hash, bool& inserted) {
+  std::unique_lock lock{shard.mutex};
+
+  const auto [cached_pipeline, did_insert] = shard.query_to_pipeline.TryEmplace(query, query_hash);
+  if(did_insert) {
+    *cached_pipeline = std::make_shared<CachedPipeline>(query, query_hash);
+    m_pipeline_count.fetch_add(1u, std::memory_order_relaxed);
+
+    // Track the pipeline while the shard is still locked, so that it can never be retired before it has been tracked.
+    Track(*cached_pipeline);
+  }
+  inserted = did_insert;
+  return *cached_pipeline;
+}
+
+Result<VkPipeline> GraphicsPipelineCache::GetCompletedPipeline(const std::shared_ptr<CachedPipeline>& cached_pipeline) {
+  if(cached_pipeline->vk_result != VK_SUCCESS) {
+    // Forget about the failed compilation, so that the pipeline is compiled again when it is requested the next time.
+    Retire(cached_pipeline);
+    return VkResultToMGPUResult(cached_pipeline->vk_result);
+  }
+  return cached_pipeline->vk_pipeline;
+}
+
+void GraphicsPipelineCache::MarkUsed(CachedPipeline& cached_pipeline) {
+  // Only needed for eviction, so avoid touching the shared counter if the number of pipelines is unlimited.
+  if(m_max_pipeline_count != 0u) {
+    cached_pipeline.last_use.store(m_use_counter.fetch_add(1u, std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+}
+
+GraphicsPipelineCache::PipelinePin GraphicsPipelineCache::Pin(const std::shared_ptr<CachedPipeline>& cached_pipeline) {
+  // The eviction checks the pin count while it holds the shard lock exclusively, so the pin must be taken while holding the shard lock.
+  cached_pipeline->pin_count.fetch_add(1u, std::memory_order_relaxed);
+  return PipelinePin{cached_pipeline.get(), [cached_pipeline](void*) {
+    cached_pipeline->pin_count.fetch_sub(1u, std::memory_order_relaxed);
+  }};
+}
+
+void GraphicsPipelineCache::Track(const std::shared_ptr<CachedPipeline>& cached_pipeline) {
+  std::lock_guard lock_guard{m_dependency_mutex};
+
+  for(const void* state : GetStates(cached_pipeline->query)) {
+    m_state_to_pipelines[state].insert(cached_pipeline);
+  }
+}
+
+void GraphicsPipelineCache::Untrack(const std::shared_ptr<CachedPipeline>& cached_pipeline) {
+  std::lock_guard lock_guard{m_dependency_mutex};
+
+  for(const void* state : GetStates(cached_pipeline->query)) {
+    // The state may have been invalidated already, in which case it has been removed from the map.
+    const auto match = m_state_to_pipelines.find(state);
+    if(match != m_state_to_pipelines.end()) {
+      match->second.erase(cached_pipeline);
+      if(match->second.empty()) {
+        m_state_to_pipelines.erase(match);
+      }
+    }
+  }
+}
+
+void GraphicsPipelineCache::Retire(const std::shared_ptr<CachedPipeline>& cached_pipeline, bool evict) {
+  {
+    Shard& shard = GetShard(cached_pipeline->query_hash);
+    std::unique_lock lock{shard.mutex};
+
+    // Another thread may have retired the pipeline (and possibly inserted a new one for the same query) already.
+    const std::shared_ptr<CachedPipeline>* match = shard.query_to_pipeline.Find(cached_pipeline->query, cached_pipeline->query_hash);
+    if(match == nullptr || *match != cached_pipeline) {
+      return;
+    }
+
+    // The pipeline may have been pinned after it has been chosen for eviction.
+    if(evict && cached_pipeline->pin_count.load(std::memory_order_relaxed) != 0u) {
+      return;
+    }
+    shard.query_to_pipeline.Erase(cached_pipeline->query, cached_pipeline->query_hash);
+  }
+
+  m_pipeline_count.fetch_sub(1u, std::memory_order_relaxed);
+  Untrack(cached_pipeline);
+
+  if(cached_pipeline->vk_pipeline != VK_NULL_HANDLE) {
     // Defer deletion of underlying Vulkan resources until the currently recorded frame has been fully processed on the GPU.
     VkDevice vk_device = m_vk_device;
+    VkPipeline vk_pipeline = cached_pipeline->vk_pipeline;
     m_deleter_queue->Schedule([vk_device, vk_pipeline]() {
       vkDestroyPipeline(vk_device, vk_pipeline, nullptr);
     });
   }
 }
 
-Result<VkPipeline> GraphicsPipelineCache::GetPipeline(const GraphicsPipelineQuery& query) {
-  VkPipeline vk_pipeline = m_query_to_vk_pipeline[query];
+void GraphicsPipelineCache::EvictLeastRecentlyUsed() {
+  if(m_max_pipeline_count == 0u || m_pipeline_count.load(std::memory_order_relaxed) <= m_max_pipeline_count) {
+    return;
+  }
+
+  // Eviction requires a pass over all pipelines, so let only one thread evict at a time.
+  // Other threads do not need to wait for it to complete, since the limit only is exceeded for a short moment.
+  std::unique_lock lock{m_eviction_mutex, std::try_to_lock};
+  if(!lock.owns_lock()) {
+    return;
+  }
+
+  // Evict more pipelines than strictly necessary, so that the pass over all pipelines is not repeated for every new pipeline.
+  const size_t pipeline_count = m_pipeline_count.load(std::memory_order_relaxed);
+  const size_t target_pipeline_count = m_max_pipeline_count - m_max_pipeline_count / 8u;
+  if(pipeline_count <= target_pipeline_count) {
+    return;
+  }
+
+  // Pipelines which are still being compiled or which are pinned cannot be evicted.
+  std::vector<std::shared_ptr<CachedPipeline>> candidates{};
+  for(Shard& shard : m_shards) {
+    std::shared_lock shard_lock{shard.mutex};
+
+    shard.query_to_pipeline.ForEach([&](const GraphicsPipelineQuery&, const std::shared_ptr<CachedPipeline>& cached_pipeline) {
+      if(cached_pipeline->done.load(std::memory_order_acquire) && cached_pipeline->pin_count.load(std::memory_order_relaxed) == 0u) {
+        candidates.push_back(cached_pipeline);
+      }
+    });
+  }
+
+  const size_t eviction_count = std::min(pipeline_count - target_pipeline_count, candidates.size());
+
+  std::nth_element(candidates.begin(), candidates.begin() + eviction_count, candidates.end(), [](const auto& a, const auto& b) {
+    return a->last_use.load(std::memory_order_relaxed) < b->last_use.load(std::memory_order_relaxed);
+  });
 
-  if(vk_pipeline != nullptr) {
-    return vk_pipeline;
+  for(size_t i = 0; i < eviction_count; i++) {
+    Retire(candidates[i], true);
   }
+}
+
+void GraphicsPipelineCache::CompilePipeline(const GraphicsPipelineQuery& query, std::shared_ptr<CachedPipeline> cached_pipeline) {
+  cached_pipeline->vk_result = CreatePipeline(m_vk_device, m_vk_pipeline_cache, GraphicsPipelineDescription{query}, cached_pipeline->vk_pipeline);
+  cached_pipeline->done.store(true, std::memory_order_release);
+  cached_pipeline->done.notify_all();
+}
+
+void GraphicsPipelineCache::EnqueuePipeline(const GraphicsPipelineQuery& query, std::shared_ptr<CachedPipeline> cached_pipeline, PipelineCompiler& pipeline_compiler) {
+  // Copy all state that the pipeline is created from, because the state objects may be destroyed while the pipeline is being compiled.
+  // Only the shader program is kept alive, since it waits for pending compilations before it is destroyed.
+  auto description = std::make_shared<GraphicsPipelineDescription>(query);
 
+  pipeline_compiler.Enqueue([vk_device = m_vk_device, vk_pipeline_cache = m_vk_pipeline_cache, description, cached_pipeline = std::move(cached_pipeline)]() {
+    cached_pipeline->vk_result = CreatePipeline(vk_device, vk_pipeline_cache, *description, cached_pipeline->vk_pipeline);
+    cached_pipeline->done.store(true, std::memory_order_release);
+    cached_pipeline->done.notify_all();
+  });
+}
+
+GraphicsPipelineCache::GraphicsPipelineDescription::GraphicsPipelineDescription(const GraphicsPipelineQuery& query) {
   const std::span<const VkPipelineShaderStageCreateInfo> vk_shader_stages = query.m_shader_program->GetVkShaderStages();
+  m_vk_shader_stages.assign(vk_shader_stages.begin(), vk_shader_stages.end());
+
+  const VkPipelineVertexInputStateCreateInfo& vk_vertex_input_state = query.m_vertex_input_state->GetVkVertexInputState();
+  m_vk_vertex_input_bindings.assign(
+    vk_vertex_input_state.pVertexBindingDescriptions,
+    vk_vertex_input_state.pVertexBindingDescriptions + vk_vertex_input_state.vertexBindingDescriptionCount);
+  m_vk_vertex_input_attributes.assign(
+    vk_vertex_input_state.pVertexAttributeDescriptions,
+    vk_vertex_input_state.pVertexAttributeDescriptions + vk_vertex_input_state.vertexAttributeDescriptionCount);
+  m_vk_vertex_input_state = vk_vertex_input_state;
+  m_vk_vertex_input_state.pVertexBindingDescriptions = m_vk_vertex_input_bindings.data();
+  m_vk_vertex_input_state.pVertexAttributeDescriptions = m_vk_vertex_input_attributes.data();
+
+  const VkPipelineColorBlendStateCreateInfo& vk_color_blend_state = query.m_color_blend_state->GetVkColorBlendState();
+  m_vk_color_blend_attachments.assign(vk_color_blend_state.pAttachments, vk_color_blend_state.pAttachments + vk_color_blend_state.attachmentCount);
+  m_vk_color_blend_state = vk_color_blend_state;
+  m_vk_color_blend_state.pAttachments = m_vk_color_blend_attachments.data();
+
+  m_vk_input_assembly_state = query.m_input_assembly_state->GetVkInputAssemblyState();
+  m_vk_rasterization_state = query.m_rasterizer_state->GetVkRasterizationState();
+  m_vk_depth_stencil_state = query.m_depth_stencil_state->GetVkDepthStencilState();
+  m_vk_pipeline_layout = query.m_shader_program->GetVkPipelineLayout();
+  m_vk_render_pass = query.m_vk_render_pass;
+  m_render_target_formats = query.m_render_target_formats;
+}
 
+VkResult GraphicsPipelineCache::CreatePipeline(
+  VkDevice vk_device,
+  VkPipelineCache vk_pipeline_cache,
+  const GraphicsPipelineDescription& description,
+  VkPipeline& vk_pipeline
+) {
   // TODO(fleroviux): do not recreate these structures from scratch on every pipeline generation.
 
   const VkPipelineViewportStateCreateInfo vk_viewport_state_create_info{
@@ -92,32 +424,42 @@ Result<VkPipeline> GraphicsPipelineCache::GetPipeline(const GraphicsPipelineQuer
     .pDynamicStates = vk_dynamic_states
   };
 
+  // Without a render pass the pipeline is used with dynamic rendering and only needs to know the attachment formats.
+  const RenderTargetFormats& render_target_formats = description.m_render_target_formats;
+
+  const VkPipelineRenderingCreateInfo vk_pipeline_rendering_create_info{
+    .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+    .pNext = nullptr,
+    .viewMask = 0u,
+    .colorAttachmentCount = render_target_formats.ColorAttachmentCount(),
+    .pColorAttachmentFormats = render_target_formats.m_vk_color_attachment_formats,
+    .depthAttachmentFormat = render_target_formats.m_vk_depth_format,
+    .stencilAttachmentFormat = render_target_formats.m_vk_stencil_format
+  };
+
   const VkGraphicsPipelineCreateInfo vk_graphics_pipeline_create_info{
     .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-    .pNext = nullptr,
+    .pNext = description.m_vk_render_pass == VK_NULL_HANDLE ? &vk_pipeline_rendering_create_info : nullptr,
     .flags = 0,
-    .stageCount = (u32)vk_shader_stages.size(),
-    .pStages = vk_shader_stages.data(),
-    .pVertexInputState = &query.m_vertex_input_state->GetVkVertexInputState(),
-    .pInputAssemblyState = &query.m_input_assembly_state->GetVkInputAssemblyState(),
+    .stageCount = (u32)description.m_vk_shader_stages.size(),
+    .pStages = description.m_vk_shader_stages.data(),
+    .pVertexInputState = &description.m_vk_vertex_input_state,
+    .pInputAssemblyState = &description.m_vk_input_assembly_state,
     .pTessellationState = nullptr,
     .pViewportState = &vk_viewport_state_create_info,
-    .pRasterizationState = &query.m_rasterizer_state->GetVkRasterizationState(),
+    .pRasterizationState = &description.m_vk_rasterization_state,
     .pMultisampleState = &vk_multisample_state_create_info,
-    .pDepthStencilState = &query.m_depth_stencil_state->GetVkDepthStencilState(),
-    .pColorBlendState = &query.m_color_blend_state->GetVkColorBlendState(),
+    .pDepthStencilState = &description.m_vk_depth_stencil_state,
+    .pColorBlendState = &description.m_vk_color_blend_state,
     .pDynamicState = &vk_dynamic_state_create_info,
-    .layout = query.m_shader_program->GetVkPipelineLayout(),
-    .renderPass = query.m_vk_render_pass,
+    .layout = description.m_vk_pipeline_layout,
+    .renderPass = description.m_vk_render_pass,
     .subpass = 0,
     .basePipelineHandle = VK_NULL_HANDLE,
     .basePipelineIndex = 0
   };
 
-  MGPU_VK_FORWARD_ERROR(vkCreateGraphicsPipelines(m_vk_device, nullptr, 1u, &vk_graphics_pipeline_create_info, nullptr, &vk_pipeline));
-  m_query_to_vk_pipeline[query] = vk_pipeline;
-  return vk_pipeline;
+  return vkCreateGraphicsPipelines(vk_device, vk_pipeline_cache, 1u, &vk_graphics_pipeline_create_info, nullptr, &vk_pipeline);
 }
 
-
 } // namespace mgpu::vulkan
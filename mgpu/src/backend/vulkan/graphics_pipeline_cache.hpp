@@ -1,13 +1,24 @@
 
 #pragma once
 
+#include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <vulkan/vulkan.h>
 
+#include "common/flat_hash_map.hpp"
 #include "common/result.hpp"
 #include "deleter_queue.hpp"
-
-// TODO(fleroviux): invalidate cache entries when any associated pipelines are destroyed.
+#include "pipeline_compiler.hpp"
+#include "render_pass_cache.hpp"
 
 namespace mgpu::vulkan {
 
@@ -29,22 +40,128 @@ struct GraphicsPipelineQuery {
   const ColorBlendState* m_color_blend_state{};
   const VertexInputState* m_vertex_input_state{};
   const DepthStencilState* m_depth_stencil_state{};
+
+  // Pipelines for render passes are keyed by the render pass, while pipelines for dynamic rendering only depend on the attachment formats.
   VkRenderPass m_vk_render_pass{};
+  RenderTargetFormats m_render_target_formats{};
 
   [[nodiscard]] bool operator==(const GraphicsPipelineQuery& other_query) const;
 };
 
-class GraphicsPipelineCache {
+/**
+ * Caches graphics pipelines for all queues of a device.
+ * The cache may be accessed from multiple threads at once. It is split into shards that each have their own reader-writer lock,
+ * so that lookups of existing pipelines only take a shared lock and insertions only contend with queries that map to the same shard.
+ *
+ * Pipelines are destroyed when any of the shader programs or pipeline states that they have been created from is destroyed.
+ * Optionally the number of pipelines can be limited, in which case the least recently used pipelines are evicted.
+ * Pipelines which are pinned, for example because a command bundle has been recorded with them, are never evicted.
+ */
+class GraphicsPipelineCache : atom::NonCopyable, atom::NonMoveable {
   public:
-    GraphicsPipelineCache(VkDevice vk_device, std::shared_ptr<DeleterQueue> deleter_queue);
+    GraphicsPipelineCache(
+      VkDevice vk_device,
+      VkPipelineCache vk_pipeline_cache,
+      PipelineCompiler* pipeline_compiler,
+      std::shared_ptr<DeleterQueue> deleter_queue,
+      u32 max_pipeline_count
+    );
    ~GraphicsPipelineCache();
 
-    Result<VkPipeline> GetPipeline(const GraphicsPipelineQuery& query);
+    // Keeps a pipeline from being evicted for as long as it is held. It does not keep the pipeline alive when its states are destroyed.
+    using PipelinePin = std::shared_ptr<void>;
+
+    /**
+     * Returns the pipeline for the given query. Only if a pipeline compiler is used and wait is false, missing pipelines
+     * are compiled in the background and MGPU_NOT_READY is returned until compilation has completed.
+     * Otherwise the call blocks until the pipeline is ready, even if it is being compiled by another thread.
+     * The query hash must have been computed with GraphicsPipelineQuery::Hasher.
+     * If pin is not null, it receives a pin for the returned pipeline.
+     */
+    Result<VkPipeline> GetPipeline(const GraphicsPipelineQuery& query, size_t query_hash, bool wait, PipelinePin* pin = nullptr);
+
+    /// Compiles all missing pipelines in parallel on the given pipeline compiler and waits for them to complete.
+    MGPUResult Precompile(std::span<const GraphicsPipelineQuery> queries, PipelineCompiler& pipeline_compiler);
+
+    /**
+     * Destroys all pipelines which have been created from the given shader program or pipeline state.
+     * Must be called when the state is destroyed, since a new state may be allocated at the same address later.
+     */
+    void Invalidate(const void* state);
 
   private:
+    struct GraphicsPipelineDescription {
+      explicit GraphicsPipelineDescription(const GraphicsPipelineQuery& query);
+
+      std::vector<VkPipelineShaderStageCreateInfo> m_vk_shader_stages{};
+      std::vector<VkVertexInputBindingDescription> m_vk_vertex_input_bindings{};
+      std::vector<VkVertexInputAttributeDescription> m_vk_vertex_input_attributes{};
+      std::vector<VkPipelineColorBlendAttachmentState> m_vk_color_blend_attachments{};
+      VkPipelineVertexInputStateCreateInfo m_vk_vertex_input_state{};
+      VkPipelineInputAssemblyStateCreateInfo m_vk_input_assembly_state{};
+      VkPipelineRasterizationStateCreateInfo m_vk_rasterization_state{};
+      VkPipelineDepthStencilStateCreateInfo m_vk_depth_stencil_state{};
+      VkPipelineColorBlendStateCreateInfo m_vk_color_blend_state{};
+      VkPipelineLayout m_vk_pipeline_layout{};
+      VkRenderPass m_vk_render_pass{};
+      RenderTargetFormats m_render_target_formats{};
+    };
+
+    // vk_result and vk_pipeline may only be read once done is set.
+    struct CachedPipeline {
+      CachedPipeline(const GraphicsPipelineQuery& query, size_t query_hash) : query{query}, query_hash{query_hash} {}
+
+      const GraphicsPipelineQuery query;
+      const size_t query_hash;
+      std::atomic<bool> done{false};
+      std::atomic<u64> last_use{};
+      std::atomic<u32> pin_count{};
+      VkResult vk_result{};
+      VkPipeline vk_pipeline{};
+    };
+
+    struct Shard {
+      std::shared_mutex mutex{};
+      FlatHashMap<GraphicsPipelineQuery, std::shared_ptr<CachedPipeline>> query_to_pipeline{};
+    };
+
+    static constexpr int k_shard_bits = 4;
+    static constexpr size_t k_shard_count = 1u << k_shard_bits;
+
+    Shard& GetShard(size_t query_hash);
+    std::shared_ptr<CachedPipeline> FindOrInsert(Shard& shard, const GraphicsPipelineQuery& query, size_t query_hash, bool& inserted);
+    Result<VkPipeline> GetCompletedPipeline(const std::shared_ptr<CachedPipeline>& cached_pipeline);
+    void MarkUsed(CachedPipeline& cached_pipeline);
+    static PipelinePin Pin(const std::shared_ptr<CachedPipeline>& cached_pipeline);
+    void Track(const std::shared_ptr<CachedPipeline>& cached_pipeline);
+    void Untrack(const std::shared_ptr<CachedPipeline>& cached_pipeline);
+    void Retire(const std::shared_ptr<CachedPipeline>& cached_pipeline, bool evict = false);
+    void EvictLeastRecentlyUsed();
+    void CompilePipeline(const GraphicsPipelineQuery& query, std::shared_ptr<CachedPipeline> cached_pipeline);
+    void EnqueuePipeline(const GraphicsPipelineQuery& query, std::shared_ptr<CachedPipeline> cached_pipeline, PipelineCompiler& pipeline_compiler);
+
+    static VkResult CreatePipeline(
+      VkDevice vk_device,
+      VkPipelineCache vk_pipeline_cache,
+      const GraphicsPipelineDescription& description,
+      VkPipeline& vk_pipeline
+    );
+
     VkDevice m_vk_device;
+    VkPipelineCache m_vk_pipeline_cache;
+    PipelineCompiler* m_pipeline_compiler;
     std::shared_ptr<DeleterQueue> m_deleter_queue;
-    std::unordered_map<GraphicsPipelineQuery, VkPipeline, GraphicsPipelineQuery::Hasher> m_query_to_vk_pipeline{};
+    Shard m_shards[k_shard_count]{};
+
+    // Maps each shader program and pipeline state to the pipelines that have been created from it.
+    std::mutex m_dependency_mutex{};
+    std::unordered_map<const void*, std::unordered_set<std::shared_ptr<CachedPipeline>>> m_state_to_pipelines{};
+
+    // Zero if the number of pipelines is unlimited.
+    u32 m_max_pipeline_count;
+    std::atomic<size_t> m_pipeline_count{};
+    std::atomic<u64> m_use_counter{};
+    std::mutex m_eviction_mutex{};
 };
 
 } // namespace mgpu::vulkan
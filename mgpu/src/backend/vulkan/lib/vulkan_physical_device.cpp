@@ -65,11 +65,12 @@ bool VulkanPhysicalDevice::QueryDeviceLayerSupport(const char* layer_name) const
   std::span<const VkDeviceQueueCreateInfo> queue_create_infos,
   std::span<const char* const> required_device_extensions,
   std::span<const char* const> required_device_layers,
-  const VkPhysicalDeviceFeatures* physical_device_features
+  const VkPhysicalDeviceFeatures* physical_device_features,
+  const void* device_create_info_next
 ) const {
   const VkDeviceCreateInfo create_info{
     .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-    .pNext = nullptr,
+    .pNext = device_create_info_next,
     .flags = 0,
     .queueCreateInfoCount = (u32)queue_create_infos.size(),
     .pQueueCreateInfos = queue_create_infos.data(),
@@ -33,7 +33,8 @@ class VulkanPhysicalDevice {
       std::span<const VkDeviceQueueCreateInfo> queue_create_infos,
       std::span<const char* const> required_device_extensions,
       std::span<const char* const> required_device_layers,
-      const VkPhysicalDeviceFeatures* physical_device_features = nullptr
+      const VkPhysicalDeviceFeatures* physical_device_features = nullptr,
+      const void* device_create_info_next = nullptr
     ) const;
 
     [[nodiscard]] VkPhysicalDevice Handle() const {
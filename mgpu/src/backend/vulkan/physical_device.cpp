@@ -103,8 +103,8 @@ Result<std::vector<MGPUPresentMode>> PhysicalDevice::EnumerateSurfacePresentMode
   return mgpu_present_modes;
 }
 
-Result<DeviceBase*> PhysicalDevice::CreateDevice() {
-  return Device::Create(m_vk_instance, m_vk_physical_device, m_queue_family_indices, Limits());
+Result<DeviceBase*> PhysicalDevice::CreateDevice(const MGPUDeviceCreateInfo& create_info) {
+  return Device::Create(m_vk_instance, m_vk_physical_device, m_queue_family_indices, Limits(), create_info);
 }
 
 MGPUPhysicalDeviceInfo PhysicalDevice::GetInfo(VulkanPhysicalDevice& vk_physical_device) {
@@ -124,9 +124,28 @@ MGPUPhysicalDeviceInfo PhysicalDevice::GetInfo(VulkanPhysicalDevice& vk_physical
   std::strcpy(mgpu_device_info.device_name, vk_device_props.deviceName);
   mgpu_device_info.device_type = mgpu_physical_device_type;
   mgpu_device_info.limits = GetLimits(vk_device_props.limits);
+  mgpu_device_info.limits.draw_indirect_count = QueryDrawIndirectCountSupport(vk_physical_device);
   return mgpu_device_info;
 }
 
+bool PhysicalDevice::QueryDrawIndirectCountSupport(VulkanPhysicalDevice& vk_physical_device) {
+  if(vk_physical_device.GetProperties().apiVersion < VK_API_VERSION_1_2) {
+    return false;
+  }
+
+  VkPhysicalDeviceVulkan12Features vk_vulkan12_features{};
+  vk_vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+  VkPhysicalDeviceFeatures2 vk_physical_device_features2{
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+    .pNext = &vk_vulkan12_features,
+    .features = {}
+  };
+  vkGetPhysicalDeviceFeatures2(vk_physical_device.Handle(), &vk_physical_device_features2);
+
+  return vk_vulkan12_features.drawIndirectCount == VK_TRUE;
+}
+
 MGPUPhysicalDeviceLimits PhysicalDevice::GetLimits(const VkPhysicalDeviceLimits& vk_device_limits) {
   MGPUPhysicalDeviceLimits mgpu_device_limits{};
 
@@ -144,6 +163,13 @@ MGPUPhysicalDeviceLimits PhysicalDevice::GetLimits(const VkPhysicalDeviceLimits&
   mgpu_device_limits.max_vertex_input_attributes = std::min<u32>(vk_device_limits.maxVertexInputAttributes, limits::max_vertex_input_attributes);
   mgpu_device_limits.max_vertex_input_binding_stride = vk_device_limits.maxVertexInputBindingStride;
   mgpu_device_limits.max_vertex_input_attribute_offset = vk_device_limits.maxVertexInputAttributeOffset;
+  mgpu_device_limits.max_draw_indirect_count = vk_device_limits.maxDrawIndirectCount; // One, unless multiDrawIndirect is supported.
+  mgpu_device_limits.max_push_constants_size = std::min<u32>(vk_device_limits.maxPushConstantsSize, limits::max_push_constants_size);
+  for(size_t i = 0u; i < 3u; i++) {
+    mgpu_device_limits.max_compute_work_group_count[i] = vk_device_limits.maxComputeWorkGroupCount[i];
+  }
+  mgpu_device_limits.min_uniform_buffer_offset_alignment = vk_device_limits.minUniformBufferOffsetAlignment;
+  mgpu_device_limits.min_storage_buffer_offset_alignment = vk_device_limits.minStorageBufferOffsetAlignment;
 
   return mgpu_device_limits;
 }
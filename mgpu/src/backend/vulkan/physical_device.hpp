@@ -21,11 +21,12 @@ class PhysicalDevice final : public PhysicalDeviceBase {
     Result<MGPUSurfaceCapabilities> GetSurfaceCapabilities(mgpu::SurfaceBase* surface) override;
     Result<std::vector<MGPUSurfaceFormat>> EnumerateSurfaceFormats(mgpu::SurfaceBase* surface) override;
     Result<std::vector<MGPUPresentMode>> EnumerateSurfacePresentModes(mgpu::SurfaceBase* surface) override;
-    Result<DeviceBase*> CreateDevice() override;
+    Result<DeviceBase*> CreateDevice(const MGPUDeviceCreateInfo& create_info) override;
 
   private:
     //void PopulatePhysicalDeviceInfo();
     static MGPUPhysicalDeviceInfo GetInfo(VulkanPhysicalDevice& vk_physical_device);
+    static bool QueryDrawIndirectCountSupport(VulkanPhysicalDevice& vk_physical_device);
     static MGPUPhysicalDeviceLimits GetLimits(const VkPhysicalDeviceLimits& vk_device_limits);
 
     VkInstance m_vk_instance{};
@@ -0,0 +1,138 @@
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "backend/vulkan/lib/vulkan_result.hpp"
+#include "pipeline_cache.hpp"
+
+namespace mgpu::vulkan {
+
+PipelineCache::PipelineCache(VkDevice vk_device, VkPipelineCache vk_pipeline_cache, std::string path)
+    : m_vk_device{vk_device}
+    , m_vk_pipeline_cache{vk_pipeline_cache}
+    , m_path{std::move(path)} {
+}
+
+PipelineCache::~PipelineCache() {
+  // There is no one to report a failure to at this point. In the worst case the next run starts with a cold cache.
+  (void)Store();
+  vkDestroyPipelineCache(m_vk_device, m_vk_pipeline_cache, nullptr);
+}
+
+Result<std::unique_ptr<PipelineCache>> PipelineCache::Create(
+  VkDevice vk_device,
+  const VkPhysicalDeviceProperties& vk_physical_device_properties,
+  const MGPUDeviceCreateInfo& create_info
+) {
+  std::string path{};
+  std::vector<u8> file_data{};
+  std::span<const u8> initial_data{};
+
+  if(create_info.pipeline_cache_path != nullptr) {
+    path = create_info.pipeline_cache_path;
+    file_data = LoadFile(path);
+    initial_data = file_data;
+  }
+
+  if(!IsCompatible(vk_physical_device_properties, initial_data)) {
+    initial_data = {(const u8*)create_info.pipeline_cache_data, create_info.pipeline_cache_size};
+  }
+
+  if(!IsCompatible(vk_physical_device_properties, initial_data)) {
+    initial_data = {};
+  }
+
+  const VkPipelineCacheCreateInfo vk_pipeline_cache_create_info{
+    .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+    .pNext = nullptr,
+    .flags = 0,
+    .initialDataSize = initial_data.size(),
+    .pInitialData = initial_data.data()
+  };
+
+  VkPipelineCache vk_pipeline_cache{};
+  MGPU_VK_FORWARD_ERROR(vkCreatePipelineCache(vk_device, &vk_pipeline_cache_create_info, nullptr, &vk_pipeline_cache));
+  return std::unique_ptr<PipelineCache>{new PipelineCache{vk_device, vk_pipeline_cache, std::move(path)}};
+}
+
+Result<std::vector<u8>> PipelineCache::GetData() {
+  size_t data_size{};
+  MGPU_VK_FORWARD_ERROR(vkGetPipelineCacheData(m_vk_device, m_vk_pipeline_cache, &data_size, nullptr));
+
+  std::vector<u8> data{};
+  data.resize(data_size);
+  MGPU_VK_FORWARD_ERROR(vkGetPipelineCacheData(m_vk_device, m_vk_pipeline_cache, &data_size, data.data()));
+  data.resize(data_size);
+  return data;
+}
+
+MGPUResult PipelineCache::Store() {
+  if(m_path.empty()) {
+    return MGPU_SUCCESS;
+  }
+
+  Result<std::vector<u8>> data_result = GetData();
+  MGPU_FORWARD_ERROR(data_result.Code());
+
+  const std::vector<u8> data = data_result.Unwrap();
+
+  // Write to a temporary file first and then rename it over the old cache, which replaces the file atomically.
+  const std::string temporary_path = m_path + ".tmp";
+  {
+    std::ofstream file{temporary_path, std::ios::binary | std::ios::trunc};
+    file.write((const char*)data.data(), (std::streamsize)data.size());
+    file.close();
+    if(!file.good()) {
+      return MGPU_INTERNAL_ERROR;
+    }
+  }
+
+  std::error_code error_code{};
+  std::filesystem::rename(temporary_path, m_path, error_code);
+  if(error_code) {
+    std::filesystem::remove(temporary_path, error_code);
+    return MGPU_INTERNAL_ERROR;
+  }
+  return MGPU_SUCCESS;
+}
+
+std::vector<u8> PipelineCache::LoadFile(const std::string& path) {
+  std::ifstream file{path, std::ios::binary | std::ios::ate};
+  if(!file.good()) {
+    return {};
+  }
+
+  const std::streamsize file_size = file.tellg();
+  if(file_size <= 0) {
+    return {};
+  }
+
+  std::vector<u8> data{};
+  data.resize((size_t)file_size);
+  file.seekg(0);
+  if(!file.read((char*)data.data(), file_size)) {
+    return {};
+  }
+  return data;
+}
+
+bool PipelineCache::IsCompatible(const VkPhysicalDeviceProperties& vk_physical_device_properties, std::span<const u8> data) {
+  VkPipelineCacheHeaderVersionOne header{};
+
+  if(data.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+
+  // Drivers are supposed to reject incompatible data themselves, but not all of them are robust against it.
+  return header.headerSize >= sizeof(header) &&
+         header.headerSize <= data.size() &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == vk_physical_device_properties.vendorID &&
+         header.deviceID == vk_physical_device_properties.deviceID &&
+         std::memcmp(header.pipelineCacheUUID, vk_physical_device_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+}  // namespace mgpu::vulkan
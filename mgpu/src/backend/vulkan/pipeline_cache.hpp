@@ -0,0 +1,51 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "common/result.hpp"
+
+namespace mgpu::vulkan {
+
+/**
+ * Owns the device's VkPipelineCache, which all pipelines are compiled through.
+ * The cache can be seeded from a file or a blob and is written back to the file when the cache is destroyed.
+ * Data that was produced by a different device or driver is discarded, instead of being handed to the driver.
+ */
+class PipelineCache : atom::NonCopyable, atom::NonMoveable {
+  public:
+   ~PipelineCache();
+
+    static Result<std::unique_ptr<PipelineCache>> Create(
+      VkDevice vk_device,
+      const VkPhysicalDeviceProperties& vk_physical_device_properties,
+      const MGPUDeviceCreateInfo& create_info
+    );
+
+    [[nodiscard]] VkPipelineCache Handle() { return m_vk_pipeline_cache; }
+
+    Result<std::vector<u8>> GetData();
+
+    /// Writes the cache to its file, if it has one. The file is replaced atomically, so that a crash can never leave a partial cache behind.
+    MGPUResult Store();
+
+  private:
+    PipelineCache(VkDevice vk_device, VkPipelineCache vk_pipeline_cache, std::string path);
+
+    static std::vector<u8> LoadFile(const std::string& path);
+    static bool IsCompatible(const VkPhysicalDeviceProperties& vk_physical_device_properties, std::span<const u8> data);
+
+    VkDevice m_vk_device;
+    VkPipelineCache m_vk_pipeline_cache;
+    std::string m_path;
+};
+
+}  // namespace mgpu::vulkan
@@ -0,0 +1,64 @@
+
+#include "pipeline_compiler.hpp"
+
+namespace mgpu::vulkan {
+
+PipelineCompiler::PipelineCompiler(u32 thread_count) {
+  for(u32 i = 0; i < thread_count; i++) {
+    m_threads.emplace_back(&PipelineCompiler::WorkerThreadMain, this);
+  }
+}
+
+PipelineCompiler::~PipelineCompiler() {
+  // Finish all pending jobs, so that no pipeline is leaked and no job outlives the objects that it references.
+  WaitIdle();
+
+  {
+    std::lock_guard lock_guard{m_mutex};
+    m_stop = true;
+  }
+  m_job_available.notify_all();
+
+  for(auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void PipelineCompiler::Enqueue(Job job) {
+  {
+    std::lock_guard lock_guard{m_mutex};
+    m_jobs.push_back(std::move(job));
+    m_pending_job_count++;
+  }
+  m_job_available.notify_one();
+}
+
+void PipelineCompiler::WaitIdle() {
+  std::unique_lock lock{m_mutex};
+  m_idle.wait(lock, [this]() { return m_pending_job_count == 0u; });
+}
+
+void PipelineCompiler::WorkerThreadMain() {
+  std::unique_lock lock{m_mutex};
+
+  while(true) {
+    m_job_available.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+
+    if(m_jobs.empty()) {
+      return;
+    }
+
+    Job job = std::move(m_jobs.front());
+    m_jobs.pop_front();
+
+    lock.unlock();
+    job();
+    lock.lock();
+
+    if(--m_pending_job_count == 0u) {
+      m_idle.notify_all();
+    }
+  }
+}
+
+}  // namespace mgpu::vulkan
@@ -0,0 +1,46 @@
+
+#pragma once
+
+#include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mgpu::vulkan {
+
+/**
+ * A pool of worker threads which compile pipelines in the background, so that the submitting thread never has to wait for the driver.
+ * Jobs must not reference any objects that may be destroyed while the job is still pending, except for objects which call WaitIdle() before their destruction.
+ */
+class PipelineCompiler : atom::NonCopyable, atom::NonMoveable {
+  public:
+    using Job = std::function<void(void)>;
+
+    explicit PipelineCompiler(u32 thread_count);
+   ~PipelineCompiler();
+
+    void Enqueue(Job job);
+    void WaitIdle();
+
+    /// Returns the number of jobs which have been enqueued but not completed yet. May be called from any thread.
+    [[nodiscard]] u32 GetPendingJobCount() const { return m_pending_job_count.load(std::memory_order_relaxed); }
+
+  private:
+    void WorkerThreadMain();
+
+    std::vector<std::thread> m_threads{};
+    std::mutex m_mutex{};
+    std::condition_variable m_job_available{};
+    std::condition_variable m_idle{};
+    std::deque<Job> m_jobs{};
+    std::atomic<u32> m_pending_job_count{};
+    bool m_stop{};
+};
+
+}  // namespace mgpu::vulkan
@@ -1,10 +1,14 @@
 
 #include "backend/vulkan/conversion.hpp"
+#include "backend/vulkan/graphics_pipeline_cache.hpp"
 #include "color_blend_state.hpp"
 
 namespace mgpu::vulkan {
 
-ColorBlendState::ColorBlendState(const MGPUColorBlendStateCreateInfo& create_info) {
+ColorBlendState::ColorBlendState(
+  const MGPUColorBlendStateCreateInfo& create_info,
+  std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache
+)   : m_graphics_pipeline_cache{std::move(graphics_pipeline_cache)} {
   for(size_t i = 0; i < create_info.attachment_count; i++) {
     const MGPUColorBlendAttachmentState& attachment_state = create_info.attachments[i];
     m_vk_color_blend_attachment_states.PushBack({
@@ -31,4 +35,10 @@ ColorBlendState::ColorBlendState(const MGPUColorBlendStateCreateInfo& create_inf
   };
 }
 
+ColorBlendState::~ColorBlendState() {
+  if(const std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache = m_graphics_pipeline_cache.lock()) {
+    graphics_pipeline_cache->Invalidate(this);
+  }
+}
+
 } // namespace mgpu::vulkan
@@ -4,6 +4,7 @@
 #include <mgpu/mgpu.h>
 
 #include <atom/vector_n.hpp>
+#include <memory>
 #include <vulkan/vulkan.h>
 
 #include "backend/pipeline_state/color_blend_state.hpp"
@@ -11,9 +12,12 @@
 
 namespace mgpu::vulkan {
 
+class GraphicsPipelineCache;
+
 class ColorBlendState final : public ColorBlendStateBase {
   public:
-    explicit ColorBlendState(const MGPUColorBlendStateCreateInfo& create_info);
+    ColorBlendState(const MGPUColorBlendStateCreateInfo& create_info, std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache);
+   ~ColorBlendState() override;
 
     [[nodiscard]] const VkPipelineColorBlendStateCreateInfo& GetVkColorBlendState() const {
       return m_vk_color_blend_state;
@@ -22,6 +26,7 @@ class ColorBlendState final : public ColorBlendStateBase {
   private:
     VkPipelineColorBlendStateCreateInfo m_vk_color_blend_state{};
     atom::Vector_N<VkPipelineColorBlendAttachmentState, limits::max_color_attachments> m_vk_color_blend_attachment_states{};
+    std::weak_ptr<GraphicsPipelineCache> m_graphics_pipeline_cache;
 };
 
 } // namespace mgpu::vulkan
@@ -1,10 +1,14 @@
 
 #include "backend/vulkan/conversion.hpp"
+#include "backend/vulkan/graphics_pipeline_cache.hpp"
 #include "depth_stencil_state.hpp"
 
 namespace mgpu::vulkan {
 
-DepthStencilState::DepthStencilState(const MGPUDepthStencilStateCreateInfo& create_info) {
+DepthStencilState::DepthStencilState(
+  const MGPUDepthStencilStateCreateInfo& create_info,
+  std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache
+)   : m_graphics_pipeline_cache{std::move(graphics_pipeline_cache)} {
   const auto MGPUStencilFaceStateToVkStencilOpState = [](const MGPUStencilFaceState& stencil_face_state) {
     return VkStencilOpState{
       .failOp = MGPUStencilOpToVkStencilOp(stencil_face_state.fail_op),
@@ -34,4 +38,10 @@ DepthStencilState::DepthStencilState(const MGPUDepthStencilStateCreateInfo& crea
   };
 }
 
+DepthStencilState::~DepthStencilState() {
+  if(const std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache = m_graphics_pipeline_cache.lock()) {
+    graphics_pipeline_cache->Invalidate(this);
+  }
+}
+
 } // namespace mgpu::vulkan
\ No newline at end of file
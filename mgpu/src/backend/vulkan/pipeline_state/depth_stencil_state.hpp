@@ -2,15 +2,19 @@
 #pragma once
 
 #include <mgpu/mgpu.h>
+#include <memory>
 #include <vulkan/vulkan.h>
 
 #include "backend/pipeline_state/depth_stencil_state.hpp"
 
 namespace mgpu::vulkan {
 
+class GraphicsPipelineCache;
+
 class DepthStencilState : public DepthStencilStateBase {
   public:
-    explicit DepthStencilState(const MGPUDepthStencilStateCreateInfo& create_info);
+    DepthStencilState(const MGPUDepthStencilStateCreateInfo& create_info, std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache);
+   ~DepthStencilState() override;
 
     [[nodiscard]] const VkPipelineDepthStencilStateCreateInfo& GetVkDepthStencilState() const {
       return m_vk_depth_stencil_state_create_info;
@@ -18,6 +22,7 @@ class DepthStencilState : public DepthStencilStateBase {
 
   private:
     VkPipelineDepthStencilStateCreateInfo m_vk_depth_stencil_state_create_info;
+    std::weak_ptr<GraphicsPipelineCache> m_graphics_pipeline_cache;
 };
 
 } // namespace mgpu::vulkan
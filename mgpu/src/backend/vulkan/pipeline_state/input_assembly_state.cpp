@@ -1,10 +1,14 @@
 
 #include "backend/vulkan/conversion.hpp"
+#include "backend/vulkan/graphics_pipeline_cache.hpp"
 #include "input_assembly_state.hpp"
 
 namespace mgpu::vulkan {
 
-InputAssemblyState::InputAssemblyState(const MGPUInputAssemblyStateCreateInfo& create_info) {
+InputAssemblyState::InputAssemblyState(
+  const MGPUInputAssemblyStateCreateInfo& create_info,
+  std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache
+)   : m_graphics_pipeline_cache{std::move(graphics_pipeline_cache)} {
   m_vk_input_assembly_state = {
     .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
     .pNext = nullptr,
@@ -14,4 +18,10 @@ InputAssemblyState::InputAssemblyState(const MGPUInputAssemblyStateCreateInfo& c
   };
 }
 
+InputAssemblyState::~InputAssemblyState() {
+  if(const std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache = m_graphics_pipeline_cache.lock()) {
+    graphics_pipeline_cache->Invalidate(this);
+  }
+}
+
 } // namespace mgpu::vulkan
@@ -2,15 +2,19 @@
 #pragma once
 
 #include <mgpu/mgpu.h>
+#include <memory>
 #include <vulkan/vulkan.h>
 
 #include "backend/pipeline_state/input_assembly_state.hpp"
 
 namespace mgpu::vulkan {
 
+class GraphicsPipelineCache;
+
 class InputAssemblyState final : public InputAssemblyStateBase {
   public:
-    explicit InputAssemblyState(const MGPUInputAssemblyStateCreateInfo& create_info);
+    InputAssemblyState(const MGPUInputAssemblyStateCreateInfo& create_info, std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache);
+   ~InputAssemblyState() override;
 
     [[nodiscard]] const VkPipelineInputAssemblyStateCreateInfo& GetVkInputAssemblyState() const {
       return m_vk_input_assembly_state;
@@ -18,6 +22,7 @@ class InputAssemblyState final : public InputAssemblyStateBase {
 
   private:
     VkPipelineInputAssemblyStateCreateInfo m_vk_input_assembly_state{};
+    std::weak_ptr<GraphicsPipelineCache> m_graphics_pipeline_cache;
 };
 
 } // namespace mgpu::vulkan
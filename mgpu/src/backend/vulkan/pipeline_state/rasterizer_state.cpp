@@ -1,10 +1,14 @@
 
 #include "backend/vulkan/conversion.hpp"
+#include "backend/vulkan/graphics_pipeline_cache.hpp"
 #include "rasterizer_state.hpp"
 
 namespace mgpu::vulkan {
 
-RasterizerState::RasterizerState(const MGPURasterizerStateCreateInfo& create_info) {
+RasterizerState::RasterizerState(
+  const MGPURasterizerStateCreateInfo& create_info,
+  std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache
+)   : m_graphics_pipeline_cache{std::move(graphics_pipeline_cache)} {
   m_vk_rasterization_state = {
     .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
     .pNext = nullptr,
@@ -22,4 +26,10 @@ RasterizerState::RasterizerState(const MGPURasterizerStateCreateInfo& create_inf
   };
 }
 
+RasterizerState::~RasterizerState() {
+  if(const std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache = m_graphics_pipeline_cache.lock()) {
+    graphics_pipeline_cache->Invalidate(this);
+  }
+}
+
 } // namespace mgpu::vulkan
@@ -2,15 +2,19 @@
 #pragma once
 
 #include <mgpu/mgpu.h>
+#include <memory>
 #include <vulkan/vulkan.h>
 
 #include "backend/pipeline_state/rasterizer_state.hpp"
 
 namespace mgpu::vulkan {
 
+class GraphicsPipelineCache;
+
 class RasterizerState final : public RasterizerStateBase {
   public:
-    explicit RasterizerState(const MGPURasterizerStateCreateInfo& create_info);
+    RasterizerState(const MGPURasterizerStateCreateInfo& create_info, std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache);
+   ~RasterizerState() override;
 
     [[nodiscard]] const VkPipelineRasterizationStateCreateInfo& GetVkRasterizationState() const {
       return m_vk_rasterization_state;
@@ -18,6 +22,7 @@ class RasterizerState final : public RasterizerStateBase {
 
   private:
     VkPipelineRasterizationStateCreateInfo m_vk_rasterization_state{};
+    std::weak_ptr<GraphicsPipelineCache> m_graphics_pipeline_cache;
 };
 
 } // namespace mgpu::vulkan
@@ -14,7 +14,8 @@ ShaderProgram::ShaderProgram(
   Device* device,
   VkPipelineLayout vk_pipeline_layout,
   const MGPUShaderProgramCreateInfo& create_info
-)   : m_device{device}
+)   : ShaderProgramBase{create_info}
+    , m_device{device}
     , m_vk_pipeline_layout{vk_pipeline_layout} {
   const auto PushShaderStage = [this](MGPUShaderModule shader_module, const char* entrypoint, VkShaderStageFlagBits shader_stage) {
     m_vk_shader_stages.PushBack({
@@ -35,6 +36,11 @@ ShaderProgram::ShaderProgram(
 }
 
 ShaderProgram::~ShaderProgram() {
+  // Pipelines which are compiled in the background still reference the shader stages and the pipeline layout.
+  m_device->WaitForPipelineCompilations();
+  m_device->GetGraphicsPipelineCache().Invalidate(this);
+  m_device->GetComputePipelineCache().Invalidate(this);
+
   Device* device = m_device;
   VkPipelineLayout vk_pipeline_layout = m_vk_pipeline_layout;
   device->GetDeleterQueue().Schedule([device, vk_pipeline_layout]() {
@@ -50,14 +56,26 @@ Result<ShaderProgramBase*> ShaderProgram::Create(Device* device, const MGPUShade
     vk_descriptor_set_layouts[i] = ((ResourceSetLayout*)create_info.resource_set_layouts[i])->Handle();
   }
 
+  std::vector<VkPushConstantRange> vk_push_constant_ranges{};
+  vk_push_constant_ranges.resize(create_info.push_constant_range_count);
+
+  for(size_t i = 0; i < create_info.push_constant_range_count; i++) {
+    const MGPUPushConstantRange& push_constant_range = create_info.push_constant_ranges[i];
+    vk_push_constant_ranges[i] = {
+      .stageFlags = MGPUShaderStagesToVkShaderStageFlags(push_constant_range.stages),
+      .offset = push_constant_range.offset,
+      .size = push_constant_range.size
+    };
+  }
+
   const VkPipelineLayoutCreateInfo vk_pipeline_layout_create_info{
     .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
     .pNext = nullptr,
     .flags = 0,
     .setLayoutCount = (u32)vk_descriptor_set_layouts.size(),
     .pSetLayouts = vk_descriptor_set_layouts.data(),
-    .pushConstantRangeCount = 0u,
-    .pPushConstantRanges = nullptr
+    .pushConstantRangeCount = (u32)vk_push_constant_ranges.size(),
+    .pPushConstantRanges = vk_push_constant_ranges.data()
   };
 
   VkPipelineLayout vk_pipeline_layout{};
@@ -1,10 +1,14 @@
 
 #include "backend/vulkan/conversion.hpp"
+#include "backend/vulkan/graphics_pipeline_cache.hpp"
 #include "vertex_input_state.hpp"
 
 namespace mgpu::vulkan {
 
-VertexInputState::VertexInputState(const MGPUVertexInputStateCreateInfo& create_info) {
+VertexInputState::VertexInputState(
+  const MGPUVertexInputStateCreateInfo& create_info,
+  std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache
+)   : m_graphics_pipeline_cache{std::move(graphics_pipeline_cache)} {
   for(size_t i = 0; i < create_info.binding_count; i++) {
     const MGPUVertexBinding& binding = create_info.bindings[i];
 
@@ -37,4 +41,10 @@ VertexInputState::VertexInputState(const MGPUVertexInputStateCreateInfo& create_
   };
 }
 
+VertexInputState::~VertexInputState() {
+  if(const std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache = m_graphics_pipeline_cache.lock()) {
+    graphics_pipeline_cache->Invalidate(this);
+  }
+}
+
 } // namespace mgpu::vulkan
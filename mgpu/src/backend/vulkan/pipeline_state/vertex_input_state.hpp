@@ -3,6 +3,7 @@
 
 #include <mgpu/mgpu.h>
 #include <atom/vector_n.hpp>
+#include <memory>
 #include <vulkan/vulkan.h>
 
 #include "backend/pipeline_state/vertex_input_state.hpp"
@@ -10,9 +11,12 @@
 
 namespace mgpu::vulkan {
 
+class GraphicsPipelineCache;
+
 class VertexInputState : public VertexInputStateBase {
   public:
-    explicit VertexInputState(const MGPUVertexInputStateCreateInfo& create_info);
+    VertexInputState(const MGPUVertexInputStateCreateInfo& create_info, std::weak_ptr<GraphicsPipelineCache> graphics_pipeline_cache);
+   ~VertexInputState() override;
 
     [[nodiscard]] const VkPipelineVertexInputStateCreateInfo& GetVkVertexInputState() const {
       return m_vk_vertex_input_state_create_info;
@@ -22,6 +26,7 @@ class VertexInputState : public VertexInputStateBase {
     atom::Vector_N<VkVertexInputBindingDescription, limits::max_vertex_input_bindings> m_vk_vertex_input_bindings{};
     atom::Vector_N<VkVertexInputAttributeDescription, limits::max_vertex_input_attributes> m_vk_vertex_input_attributes{};
     VkPipelineVertexInputStateCreateInfo m_vk_vertex_input_state_create_info;
+    std::weak_ptr<GraphicsPipelineCache> m_graphics_pipeline_cache;
 };
 
 } // namespace mgpu::vulkan
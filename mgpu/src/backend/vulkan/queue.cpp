@@ -1,6 +1,7 @@
 
 #include <atom/float.hpp>
 #include <atom/panic.hpp>
+#include <algorithm>
 #include <cstring>
 
 #include "backend/vulkan/lib/vulkan_result.hpp"
@@ -14,6 +15,7 @@
 #include "pipeline_state/shader_program.hpp"
 #include "pipeline_state/vertex_input_state.hpp"
 #include "buffer.hpp"
+#include "command_bundle.hpp"
 #include "conversion.hpp"
 #include "queue.hpp"
 #include "resource_set.hpp"
@@ -26,38 +28,57 @@ namespace mgpu::vulkan {
 Queue::Queue(
   VkDevice vk_device,
   VkQueue vk_queue,
+  u32 queue_family_index,
   VkCommandPool vk_cmd_pool,
-  std::vector<FencedCommandBuffer> fenced_cmd_buffers,
+  std::vector<SubmittedCommandBuffer> cmd_buffers,
+  VkSemaphore vk_timeline_semaphore,
   std::shared_ptr<DeleterQueue> deleter_queue,
-  std::shared_ptr<RenderPassCache> render_pass_cache
+  u32 deleter_timeline,
+  std::shared_ptr<RenderPassCache> render_pass_cache,
+  std::shared_ptr<FramebufferCache> framebuffer_cache,
+  std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache,
+  std::shared_ptr<ComputePipelineCache> compute_pipeline_cache,
+  bool use_dynamic_rendering,
+  bool drains_deleter_queue
 )   : m_vk_device{vk_device}
     , m_vk_queue{vk_queue}
+    , m_queue_family_index{queue_family_index}
     , m_vk_cmd_pool{vk_cmd_pool}
-    , m_fenced_cmd_buffers{std::move(fenced_cmd_buffers)}
-    , m_deleter_queue{deleter_queue}
+    , m_cmd_buffers{std::move(cmd_buffers)}
+    , m_vk_timeline_semaphore{vk_timeline_semaphore}
+    , m_deleter_queue{std::move(deleter_queue)}
+    , m_deleter_timeline{deleter_timeline}
+    , m_drains_deleter_queue{drains_deleter_queue}
     , m_render_pass_cache{std::move(render_pass_cache)}
-    , m_graphics_pipeline_cache{vk_device, std::move(deleter_queue)} {
+    , m_framebuffer_cache{std::move(framebuffer_cache)}
+    , m_graphics_pipeline_cache{std::move(graphics_pipeline_cache)}
+    , m_compute_pipeline_cache{std::move(compute_pipeline_cache)}
+    , m_use_dynamic_rendering{use_dynamic_rendering} {
   BeginNextCommandBuffer();
 }
 
 Queue::~Queue() {
   Flush();
+  WaitForSubmission(GetLastSubmissionIndex());
+  m_deleter_queue->RemoveTimeline(m_deleter_timeline);
 
-  for(const auto& fenced_cmd_buffer : m_fenced_cmd_buffers) {
-    if(fenced_cmd_buffer.submitted) {
-      vkWaitForFences(m_vk_device, 1u, &fenced_cmd_buffer.vk_fence, VK_TRUE, ~0ull);
-    }
-    vkDestroyFence(m_vk_device, fenced_cmd_buffer.vk_fence, nullptr);
-    vkFreeCommandBuffers(m_vk_device, m_vk_cmd_pool, 1u, &fenced_cmd_buffer.vk_cmd_buffer);
+  for(const auto& cmd_buffer : m_cmd_buffers) {
+    vkFreeCommandBuffers(m_vk_device, m_vk_cmd_pool, 1u, &cmd_buffer.vk_cmd_buffer);
   }
   vkDestroyCommandPool(m_vk_device, m_vk_cmd_pool, nullptr);
+  vkDestroySemaphore(m_vk_device, m_vk_timeline_semaphore, nullptr);
 }
 
 Result<std::unique_ptr<Queue>> Queue::Create(
   VkDevice vk_device,
   u32 queue_family_index,
   std::shared_ptr<DeleterQueue> deleter_queue,
-  std::shared_ptr<RenderPassCache> render_pass_cache
+  std::shared_ptr<RenderPassCache> render_pass_cache,
+  std::shared_ptr<FramebufferCache> framebuffer_cache,
+  std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache,
+  std::shared_ptr<ComputePipelineCache> compute_pipeline_cache,
+  bool use_dynamic_rendering,
+  bool drains_deleter_queue
 ) {
   VkQueue vk_queue{};
   vkGetDeviceQueue(vk_device, queue_family_index, 0u, &vk_queue);
@@ -83,38 +104,109 @@ Result<std::unique_ptr<Queue>> Queue::Create(
     .commandBufferCount = 1u
   };
 
-  const VkFenceCreateInfo vk_fence_create_info{
-    .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-    .pNext = nullptr,
-    .flags = 0
-  };
+  std::vector<SubmittedCommandBuffer> cmd_buffers{};
 
-  std::vector<FencedCommandBuffer> fenced_cmd_buffers{};
+  // Releases the command buffers allocated so far and the command pool, when creating the queue fails.
+  const auto DestroyCommandBuffers = [&]() {
+    for(const SubmittedCommandBuffer& cmd_buffer : cmd_buffers) {
+      vkFreeCommandBuffers(vk_device, vk_cmd_pool, 1u, &cmd_buffer.vk_cmd_buffer);
+    }
+    vkDestroyCommandPool(vk_device, vk_cmd_pool, nullptr);
+  };
 
   for(size_t i = 0; i < k_command_buffer_count; i++) {
-    // TODO(fleroviux): if this fails we will leak memory
     VkCommandBuffer vk_cmd_buffer{};
-    MGPU_VK_FORWARD_ERROR(vkAllocateCommandBuffers(vk_device, &vk_cmd_buffer_alloc_info, &vk_cmd_buffer));
+    const VkResult vk_result = vkAllocateCommandBuffers(vk_device, &vk_cmd_buffer_alloc_info, &vk_cmd_buffer);
+    if(vk_result != VK_SUCCESS) {
+      DestroyCommandBuffers();
+      return VkResultToMGPUResult(vk_result);
+    }
+
+    cmd_buffers.push_back({vk_cmd_buffer});
+  }
+
+  // A single timeline semaphore tracks the progress of all submissions, so that we do not need a fence per command buffer.
+  const VkSemaphoreTypeCreateInfo vk_semaphore_type_create_info{
+    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+    .pNext = nullptr,
+    .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+    .initialValue = 0u
+  };
 
-    // TODO(fleroviux): if this fails we will leak memory
-    VkFence vk_fence{};
-    MGPU_VK_FORWARD_ERROR(vkCreateFence(vk_device, &vk_fence_create_info, nullptr, &vk_fence));
+  const VkSemaphoreCreateInfo vk_semaphore_create_info{
+    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+    .pNext = &vk_semaphore_type_create_info,
+    .flags = 0
+  };
 
-    fenced_cmd_buffers.push_back({vk_cmd_buffer, vk_fence});
+  VkSemaphore vk_timeline_semaphore{};
+  const VkResult vk_result = vkCreateSemaphore(vk_device, &vk_semaphore_create_info, nullptr, &vk_timeline_semaphore);
+  if(vk_result != VK_SUCCESS) {
+    DestroyCommandBuffers();
+    return VkResultToMGPUResult(vk_result);
   }
 
+  const u32 deleter_timeline = deleter_queue->AddTimeline(vk_device, vk_timeline_semaphore);
+
   return std::unique_ptr<Queue>{new Queue{
     vk_device,
     vk_queue,
+    queue_family_index,
     vk_cmd_pool,
-    std::move(fenced_cmd_buffers),
+    std::move(cmd_buffers),
+    vk_timeline_semaphore,
     std::move(deleter_queue),
-    std::move(render_pass_cache)
+    deleter_timeline,
+    std::move(render_pass_cache),
+    std::move(framebuffer_cache),
+    std::move(graphics_pipeline_cache),
+    std::move(compute_pipeline_cache),
+    use_dynamic_rendering,
+    drains_deleter_queue
   }};
 }
 
 void Queue::SetDevice(Device* device) {
   m_device = device;
+  m_staging_ring = std::make_unique<StagingRing>(device, MGPU_BUFFER_USAGE_COPY_SRC);
+  m_transient_ring = std::make_unique<StagingRing>(device, k_transient_buffer_usage);
+}
+
+u64 Queue::GetCompletedSubmissionIndex() {
+  u64 completed_submission_index = m_completed_submission_index.load(std::memory_order_acquire);
+
+  // Polling the semaphore does not block, so this is cheap enough to do whenever we need an up-to-date value.
+  u64 semaphore_value{};
+  if(vkGetSemaphoreCounterValue(m_vk_device, m_vk_timeline_semaphore, &semaphore_value) == VK_SUCCESS) {
+    while(semaphore_value > completed_submission_index &&
+          !m_completed_submission_index.compare_exchange_weak(completed_submission_index, semaphore_value, std::memory_order_acq_rel)) {
+    }
+  }
+
+  return std::max(completed_submission_index, semaphore_value);
+}
+
+bool Queue::IsSubmissionComplete(u64 submission_index) {
+  return submission_index <= m_completed_submission_index.load(std::memory_order_acquire) || submission_index <= GetCompletedSubmissionIndex();
+}
+
+MGPUResult Queue::WaitForSubmission(u64 submission_index) {
+  if(IsSubmissionComplete(submission_index)) {
+    return MGPU_SUCCESS;
+  }
+
+  const VkSemaphoreWaitInfo vk_semaphore_wait_info{
+    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+    .pNext = nullptr,
+    .flags = 0,
+    .semaphoreCount = 1u,
+    .pSemaphores = &m_vk_timeline_semaphore,
+    .pValues = &submission_index
+  };
+  MGPU_VK_FORWARD_ERROR(vkWaitSemaphores(m_vk_device, &vk_semaphore_wait_info, ~0ull));
+
+  (void)GetCompletedSubmissionIndex();
+  return MGPU_SUCCESS;
 }
 
 void Queue::SetSwapChainAcquireSemaphore(VkSemaphore vk_swap_chain_acquire_semaphore) {
@@ -139,6 +231,11 @@ MGPUResult Queue::Present(SwapChain* swap_chain, u32 texture_index) {
     .pResults = nullptr
   };
 
+  MarkRecordedWork();
+
+  // Pending uploads must be recorded before the swap chain texture is transitioned for presentation.
+  RecordPendingUploads();
+
   // TODO(fleroviux): clean this up and ensure that the barrier is correct.
   ((Texture*)swap_chain->EnumerateTextures().Unwrap()[texture_index])->TransitionState({
     .m_image_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
@@ -153,112 +250,229 @@ MGPUResult Queue::Present(SwapChain* swap_chain, u32 texture_index) {
 }
 
 MGPUResult Queue::SubmitCommandList(const CommandList* command_list) {
-  const CommandBase* command = command_list->GetListHead();
+  MarkRecordedWork();
+
+  // Make sure that the command list sees the data of any preceding uploads.
+  RecordPendingUploads();
 
   CommandListState state{};
+  state.vk_cmd_buffer = m_vk_cmd_buffer;
+  return RecordCommandList(state, command_list);
+}
 
-  while(command != nullptr) {
-    const CommandType command_type = command->m_command_type;
-
-    switch(command_type) {
-      case CommandType::BeginRenderPass: HandleCmdBeginRenderPass(state, *(BeginRenderPassCommand*)command); break;
-      case CommandType::EndRenderPass: HandleCmdEndRenderPass(state); break;
-      case CommandType::UseShaderProgram: HandleCmdUseShaderProgram(state, *(UseShaderProgramCommand*)command); break;
-      case CommandType::UseRasterizerState: HandleCmdUseRasterizerState(state, *(UseRasterizerStateCommand*)command); break;
-      case CommandType::UseInputAssemblyState: HandleCmdUseInputAssemblyState(state, *(UseInputAssemblyStateCommand*)command); break;
-      case CommandType::UseColorBlendState: HandleCmdUseColorBlendState(state, *(UseColorBlendStateCommand*)command); break;
-      case CommandType::UseVertexInputState: HandleCmdUseVertexInputState(state, *(UseVertexInputStateCommand*)command); break;
-      case CommandType::UseDepthStencilState: HandleCmdUseDepthStencilState(state, *(UseDepthStencilStateCommand*)command); break;
-      case CommandType::SetViewport: HandleCmdSetViewport(state, *(SetViewportCommand*)command); break;
-      case CommandType::SetScissor: HandleCmdSetScissor(state, *(SetScissorCommand*)command); break;
-      case CommandType::BindVertexBuffer: HandleCmdBindVertexBuffer(state, *(BindVertexBufferCommand*)command); break;
-      case CommandType::BindIndexBuffer: HandleCmdBindIndexBuffer(state, *(BindIndexBufferCommand*)command); break;
-      case CommandType::BindResourceSet: HandleCmdBindResourceSet(state, *(BindResourceSetCommand*)command); break;
-      case CommandType::Draw: HandleCmdDraw(state, *(DrawCommand*)command); break;
-      case CommandType::DrawIndexed: HandleCmdDrawIndexed(state, *(DrawIndexedCommand*)command); break;
-      default: {
-        ATOM_PANIC("mgpu: Vulkan: unhandled command type: {}", (int)command_type);
-      }
+MGPUResult Queue::RecordCommandBundle(VkCommandBuffer vk_cmd_buffer, const CommandList* command_list, std::vector<GraphicsPipelineCache::PipelinePin>& pipeline_pins) {
+  // The command list contains exactly one render pass, which the commands in the bundle will be executed in.
+  const auto& begin_render_pass_command = (const BeginRenderPassCommand&)*command_list->begin();
+
+  const RenderPassQuery render_pass_query = GetRenderPassQuery(begin_render_pass_command);
+
+  CommandListState state{};
+  state.vk_cmd_buffer = vk_cmd_buffer;
+  state.wait_for_pipelines = true; // Skipped draws would be missing from every execution of the bundle.
+  state.pipeline_pins = &pipeline_pins; // Evicting a pipeline would leave the bundle with a dangling pipeline handle.
+
+  VkRenderPass vk_render_pass = VK_NULL_HANDLE;
+
+  if(m_use_dynamic_rendering) {
+    state.render_pass.pipeline_query.m_render_target_formats = render_pass_query.GetRenderTargetFormats();
+  } else {
+    Result<VkRenderPass> vk_render_pass_result = m_render_pass_cache->GetRenderPass(render_pass_query);
+    MGPU_FORWARD_ERROR(vk_render_pass_result.Code());
+
+    Result<VkRenderPass> vk_compatible_render_pass_result = m_render_pass_cache->GetCompatibleRenderPass(render_pass_query);
+    MGPU_FORWARD_ERROR(vk_compatible_render_pass_result.Code());
+
+    vk_render_pass = vk_render_pass_result.Unwrap();
+    state.render_pass.pipeline_query.m_vk_render_pass = vk_compatible_render_pass_result.Unwrap();
+  }
+
+  const RenderTargetFormats& render_target_formats = state.render_pass.pipeline_query.m_render_target_formats;
+
+  const VkCommandBufferInheritanceRenderingInfo vk_cmd_buffer_inheritance_rendering_info{
+    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+    .pNext = nullptr,
+    .flags = 0,
+    .viewMask = 0u,
+    .colorAttachmentCount = render_target_formats.ColorAttachmentCount(),
+    .pColorAttachmentFormats = render_target_formats.m_vk_color_attachment_formats,
+    .depthAttachmentFormat = render_target_formats.m_vk_depth_format,
+    .stencilAttachmentFormat = render_target_formats.m_vk_stencil_format,
+    .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+  };
+
+  const VkCommandBufferInheritanceInfo vk_cmd_buffer_inheritance_info{
+    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+    .pNext = m_use_dynamic_rendering ? &vk_cmd_buffer_inheritance_rendering_info : nullptr,
+    .renderPass = vk_render_pass,
+    .subpass = 0u,
+    .framebuffer = VK_NULL_HANDLE,
+    .occlusionQueryEnable = VK_FALSE,
+    .queryFlags = 0,
+    .pipelineStatistics = 0
+  };
+
+  const VkCommandBufferBeginInfo vk_cmd_buffer_begin_info{
+    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    .pNext = nullptr,
+    .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+    .pInheritanceInfo = &vk_cmd_buffer_inheritance_info
+  };
+  MGPU_VK_FORWARD_ERROR(vkBeginCommandBuffer(vk_cmd_buffer, &vk_cmd_buffer_begin_info));
+
+  // Secondary command buffers do not inherit any dynamic state from the primary command buffer.
+  SetDefaultViewportAndScissor(vk_cmd_buffer, GetRenderPassExtent(begin_render_pass_command));
+
+  for(const CommandBase& command : *command_list) {
+    const CommandType command_type = command.m_command_type;
+
+    if(command_type != CommandType::BeginRenderPass && command_type != CommandType::EndRenderPass) {
+      MGPU_FORWARD_ERROR(HandleCommand(state, command));
     }
+  }
+
+  MGPU_VK_FORWARD_ERROR(vkEndCommandBuffer(vk_cmd_buffer));
+  return MGPU_SUCCESS;
+}
+
+MGPUResult Queue::RecordCommandList(CommandListState& state, const CommandList* command_list) {
+  const CommandList::ConstIterator end = command_list->end();
 
-    command = command->m_next;
+  for(CommandList::ConstIterator command_iterator = command_list->begin(); command_iterator != end; ++command_iterator) {
+    if(command_iterator->m_command_type == CommandType::BeginRenderPass && ((const BeginRenderPassCommand&)*command_iterator).m_have_indirect_draws) {
+      TransitionIndirectBuffers(state, command_iterator);
+    }
+    MGPU_FORWARD_ERROR(HandleCommand(state, *command_iterator));
   }
+  return MGPU_SUCCESS;
+}
 
+void Queue::TransitionIndirectBuffers(CommandListState& state, CommandList::ConstIterator command_iterator) {
+  // Barriers cannot be recorded inside of the render pass, so look ahead for the buffers that its indirect draws read from.
+  const auto TransitionIndirectBuffer = [&](BufferBase* buffer) {
+    ((Buffer*)buffer)->TransitionState({VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT}, state.vk_cmd_buffer);
+  };
+
+  const auto TransitionDrawBuffers = [&](const auto& command) {
+    TransitionIndirectBuffer(command.m_buffer);
+    if(command.m_count_buffer != nullptr) {
+      TransitionIndirectBuffer(command.m_count_buffer);
+    }
+  };
+
+  while((++command_iterator)->m_command_type != CommandType::EndRenderPass) {
+    switch(command_iterator->m_command_type) {
+      case CommandType::DrawIndirect: TransitionDrawBuffers((const DrawIndirectCommand&)*command_iterator); break;
+      case CommandType::DrawIndexedIndirect: TransitionDrawBuffers((const DrawIndexedIndirectCommand&)*command_iterator); break;
+      case CommandType::ExecuteCommandBundle: {
+        for(BufferBase* buffer : ((const ExecuteCommandBundleCommand&)*command_iterator).m_command_bundle->GetIndirectBuffers()) {
+          TransitionIndirectBuffer(buffer);
+        }
+        break;
+      }
+      default: break;
+    }
+  }
+}
+
+MGPUResult Queue::HandleCommand(CommandListState& state, const CommandBase& command) {
+  const CommandType command_type = command.m_command_type;
+
+  switch(command_type) {
+    case CommandType::BeginRenderPass: return HandleCmdBeginRenderPass(state, (const BeginRenderPassCommand&)command);
+    case CommandType::EndRenderPass: HandleCmdEndRenderPass(state); break;
+    case CommandType::UseShaderProgram: HandleCmdUseShaderProgram(state, (const UseShaderProgramCommand&)command); break;
+    case CommandType::UseRasterizerState: HandleCmdUseRasterizerState(state, (const UseRasterizerStateCommand&)command); break;
+    case CommandType::UseInputAssemblyState: HandleCmdUseInputAssemblyState(state, (const UseInputAssemblyStateCommand&)command); break;
+    case CommandType::UseColorBlendState: HandleCmdUseColorBlendState(state, (const UseColorBlendStateCommand&)command); break;
+    case CommandType::UseVertexInputState: HandleCmdUseVertexInputState(state, (const UseVertexInputStateCommand&)command); break;
+    case CommandType::UseDepthStencilState: HandleCmdUseDepthStencilState(state, (const UseDepthStencilStateCommand&)command); break;
+    case CommandType::SetViewport: HandleCmdSetViewport(state, (const SetViewportCommand&)command); break;
+    case CommandType::SetScissor: HandleCmdSetScissor(state, (const SetScissorCommand&)command); break;
+    case CommandType::BindVertexBuffer: HandleCmdBindVertexBuffer(state, (const BindVertexBufferCommand&)command); break;
+    case CommandType::BindIndexBuffer: HandleCmdBindIndexBuffer(state, (const BindIndexBufferCommand&)command); break;
+    case CommandType::BindResourceSet: HandleCmdBindResourceSet(state, (const BindResourceSetCommand&)command); break;
+    case CommandType::PushConstants: HandleCmdPushConstants(state, (const PushConstantsCommand&)command); break;
+    case CommandType::Draw: HandleCmdDraw(state, (const DrawCommand&)command); break;
+    case CommandType::DrawIndexed: HandleCmdDrawIndexed(state, (const DrawIndexedCommand&)command); break;
+    case CommandType::DrawIndirect: HandleCmdDrawIndirect(state, (const DrawIndirectCommand&)command); break;
+    case CommandType::DrawIndexedIndirect: HandleCmdDrawIndexedIndirect(state, (const DrawIndexedIndirectCommand&)command); break;
+    case CommandType::ExecuteCommandBundle: HandleCmdExecuteCommandBundle(state, (const ExecuteCommandBundleCommand&)command); break;
+    case CommandType::AppendCommandList: return RecordCommandList(state, ((const AppendCommandListCommand&)command).m_command_list);
+    case CommandType::BeginComputePass: HandleCmdBeginComputePass(state); break;
+    case CommandType::EndComputePass: HandleCmdEndComputePass(state); break;
+    case CommandType::Dispatch: HandleCmdDispatch(state, (const DispatchCommand&)command); break;
+    case CommandType::DispatchIndirect: HandleCmdDispatchIndirect(state, (const DispatchIndirectCommand&)command); break;
+    default: {
+      ATOM_PANIC("mgpu: Vulkan: unhandled command type: {}", (int)command_type);
+    }
+  }
   return MGPU_SUCCESS;
 }
 
 MGPUResult Queue::BufferUpload(const BufferBase* buffer, std::span<const u8> data, u64 offset) {
+  MarkRecordedWork();
+
   const auto dst_buffer = (Buffer*)buffer;
+  const u64 size = data.size_bytes();
 
-  // Bring the buffer into a state where it's safe to copy to
-  dst_buffer->TransitionState({VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT}, m_vk_cmd_buffer);
+  Result<StagingRing::Allocation> staging_allocation_result = m_staging_ring->Allocate(size);
+  MGPU_FORWARD_ERROR(staging_allocation_result.Code());
 
-  // TODO(fleroviux): even though the spec guarantees up to 64kb of data work, it might make sense to set the threshold lower?
-  // "The additional cost of this functionality compared to buffer to buffer copies means it is only recommended for very small amounts of data, and is why it is limited to only 65536 bytes."
-  if(data.size_bytes() < 65536u && offset % 4u == 0u && data.size_bytes() % 4u == 0u) {
-    vkCmdUpdateBuffer(m_vk_cmd_buffer, dst_buffer->Handle(), offset, data.size_bytes(), data.data());
-  } else {
-    // TODO(fleroviux): instead of allocating a bunch of small, individual buffers, allocate a single, large arena staging buffer
-    Result<BufferBase*> staging_buffer_result = Buffer::Create(m_device, {
-      .size = (u64)data.size_bytes(),
-      .usage = MGPU_BUFFER_USAGE_COPY_SRC,
-      .flags = MGPU_BUFFER_FLAGS_HOST_VISIBLE
-    });
-    MGPU_FORWARD_ERROR(staging_buffer_result.Code());
+  const StagingRing::Allocation staging_allocation = staging_allocation_result.Unwrap();
+  std::memcpy(staging_allocation.address, data.data(), size);
+  MGPU_FORWARD_ERROR(staging_allocation.buffer->FlushRange(staging_allocation.offset, size));
 
-    const auto staging_buffer = (Buffer*)staging_buffer_result.Unwrap();
+  // The copy is deferred, so that all uploads to the same buffer can be done with a single barrier and a single copy.
+  PendingBufferUploads& pending_uploads = m_pending_buffer_uploads[dst_buffer];
+  std::vector<VkBufferCopy>& vk_buffer_copies = pending_uploads.vk_buffer_copies;
 
-    Result<void*> map_address_result = staging_buffer->Map();
-    MGPU_FORWARD_ERROR(map_address_result.Code());
+  const VkBuffer vk_staging_buffer = staging_allocation.buffer->Handle();
 
-    void* map_address = map_address_result.Unwrap();
-    std::memcpy(map_address, data.data(), data.size_bytes());
-    staging_buffer->FlushRange(0u, MGPU_WHOLE_SIZE);
+  const bool overlaps_pending_upload = std::any_of(vk_buffer_copies.begin(), vk_buffer_copies.end(), [&](const VkBufferCopy& vk_buffer_copy) {
+    return offset < vk_buffer_copy.dstOffset + vk_buffer_copy.size && vk_buffer_copy.dstOffset < offset + size;
+  });
 
-    // Perform a copy from our staging buffer to the destination buffer
-    const VkBufferCopy vk_buffer_copy{
-      .srcOffset = 0u,
-      .dstOffset = offset,
-      .size = data.size_bytes()
-    };
-    vkCmdCopyBuffer(m_vk_cmd_buffer, staging_buffer->Handle(), dst_buffer->Handle(), 1u, &vk_buffer_copy);
+  // The regions of a single copy must not overlap and must all be sourced from the same buffer.
+  // Record the pending uploads first in that case, so that the new upload still takes precedence over older uploads.
+  if(overlaps_pending_upload || pending_uploads.vk_staging_buffer != vk_staging_buffer) {
+    RecordPendingBufferUploads(dst_buffer, pending_uploads);
+    pending_uploads.vk_staging_buffer = vk_staging_buffer;
+  }
 
-    delete staging_buffer;
+  // Merge uploads which are contiguous both in the staging buffer and in the destination buffer.
+  if(!vk_buffer_copies.empty()) {
+    VkBufferCopy& last_vk_buffer_copy = vk_buffer_copies.back();
+    if(last_vk_buffer_copy.srcOffset + last_vk_buffer_copy.size == staging_allocation.offset &&
+       last_vk_buffer_copy.dstOffset + last_vk_buffer_copy.size == offset) {
+      last_vk_buffer_copy.size += size;
+      return MGPU_SUCCESS;
+    }
   }
 
+  vk_buffer_copies.push_back({
+    .srcOffset = staging_allocation.offset,
+    .dstOffset = offset,
+    .size = size
+  });
   return MGPU_SUCCESS;
 }
 
 MGPUResult Queue::TextureUpload(const TextureBase* texture, const MGPUTextureUploadRegion& region, const void* data) {
+  MarkRecordedWork();
+
   const auto dst_texture = (Texture*)texture;
 
   const size_t size_bytes = MGPUTextureFormatGetTexelSize(texture->Format()) * region.extent.width * region.extent.height * region.extent.depth;
 
-  // TODO(fleroviux): instead of allocating a bunch of small, individual buffers, allocate a single, large arena staging buffer
-  Result<BufferBase*> staging_buffer_result = Buffer::Create(m_device, {
-    .size = (u64)size_bytes,
-    .usage = MGPU_BUFFER_USAGE_COPY_SRC,
-    .flags = MGPU_BUFFER_FLAGS_HOST_VISIBLE
-  });
-  MGPU_FORWARD_ERROR(staging_buffer_result.Code());
-
-  const auto staging_buffer = (Buffer*)staging_buffer_result.Unwrap();
+  Result<StagingRing::Allocation> staging_allocation_result = m_staging_ring->Allocate(size_bytes);
+  MGPU_FORWARD_ERROR(staging_allocation_result.Code());
 
-  Result<void*> map_address_result = staging_buffer->Map();
-  MGPU_FORWARD_ERROR(map_address_result.Code());
-
-  void* map_address = map_address_result.Unwrap();
-  std::memcpy(map_address, data, size_bytes);
-  staging_buffer->FlushRange(0u, MGPU_WHOLE_SIZE);
-
-  dst_texture->TransitionState({
-    .m_image_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-    .m_access = VK_ACCESS_TRANSFER_WRITE_BIT,
-    .m_pipeline_stages = VK_PIPELINE_STAGE_TRANSFER_BIT
-  }, m_vk_cmd_buffer);
+  const StagingRing::Allocation staging_allocation = staging_allocation_result.Unwrap();
+  std::memcpy(staging_allocation.address, data, size_bytes);
+  MGPU_FORWARD_ERROR(staging_allocation.buffer->FlushRange(staging_allocation.offset, size_bytes));
 
   const VkBufferImageCopy vk_buffer_image_copy{
-    .bufferOffset = 0u,
+    .bufferOffset = staging_allocation.offset,
     .bufferRowLength = 0u,
     .bufferImageHeight = 0u,
     .imageSubresource = {
@@ -270,12 +484,65 @@ MGPUResult Queue::TextureUpload(const TextureBase* texture, const MGPUTextureUpl
     .imageOffset = MGPUOffset3DToVkOffset3D(region.offset),
     .imageExtent = MGPUExtent3DToVkExtent3D(region.extent)
   };
-  vkCmdCopyBufferToImage(m_vk_cmd_buffer, staging_buffer->Handle(), dst_texture->Handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1u, &vk_buffer_image_copy);
 
-  delete staging_buffer;
+  // Same as for buffers: defer the copy, so that uploads to the same texture can be batched.
+  PendingTextureUploads& pending_uploads = m_pending_texture_uploads[dst_texture];
+  std::vector<VkBufferImageCopy>& vk_buffer_image_copies = pending_uploads.vk_buffer_image_copies;
+
+  const VkBuffer vk_staging_buffer = staging_allocation.buffer->Handle();
+
+  const bool overlaps_pending_upload = std::any_of(vk_buffer_image_copies.begin(), vk_buffer_image_copies.end(), [&](const VkBufferImageCopy& other_vk_buffer_image_copy) {
+    return TextureRegionsOverlap(vk_buffer_image_copy, other_vk_buffer_image_copy);
+  });
+
+  if(overlaps_pending_upload || pending_uploads.vk_staging_buffer != vk_staging_buffer) {
+    RecordPendingTextureUploads(dst_texture, pending_uploads);
+    pending_uploads.vk_staging_buffer = vk_staging_buffer;
+  }
+
+  vk_buffer_image_copies.push_back(vk_buffer_image_copy);
   return MGPU_SUCCESS;
 }
 
+void Queue::DiscardPendingUploads(const Buffer* buffer) {
+  // Uploads which have not been recorded yet cannot be observed by any command, so it is safe to drop them.
+  m_pending_buffer_uploads.erase((Buffer*)buffer);
+}
+
+void Queue::DiscardPendingUploads(const Texture* texture) {
+  m_pending_texture_uploads.erase((Texture*)texture);
+}
+
+Result<QueueBase::TransientAllocation> Queue::AllocateTransient(u64 size, u64 alignment, MGPUBufferUsage usage) {
+  const MGPUPhysicalDeviceLimits& limits = m_device->Limits();
+  if(usage & MGPU_BUFFER_USAGE_UNIFORM_BUFFER) {
+    alignment = std::max(alignment, limits.min_uniform_buffer_offset_alignment);
+  }
+  if(usage & MGPU_BUFFER_USAGE_STORAGE_BUFFER) {
+    alignment = std::max(alignment, limits.min_storage_buffer_offset_alignment);
+  }
+
+  // Host writes to the memory are flushed when the current command buffer is submitted.
+  Result<StagingRing::Allocation> transient_allocation_result = m_transient_ring->Allocate(size, alignment);
+  MGPU_FORWARD_ERROR(transient_allocation_result.Code());
+
+  const StagingRing::Allocation transient_allocation = transient_allocation_result.Unwrap();
+  return TransientAllocation{transient_allocation.buffer, transient_allocation.offset, transient_allocation.address};
+}
+
+Result<ResourceSetBase*> Queue::CreateTransientResourceSet(const MGPUResourceSetCreateInfo& create_info) {
+  SubmittedCommandBuffer& cmd_buffer = m_cmd_buffers[m_current_cmd_buffer];
+  if(cmd_buffer.transient_descriptor_allocator == nullptr) {
+    cmd_buffer.transient_descriptor_allocator = std::make_unique<TransientDescriptorAllocator>(m_vk_device);
+  }
+
+  Result<std::unique_ptr<ResourceSet>> resource_set_result = ResourceSet::CreateTransient(m_device, *cmd_buffer.transient_descriptor_allocator, create_info);
+  MGPU_FORWARD_ERROR(resource_set_result.Code());
+
+  ResourceSet* resource_set = cmd_buffer.transient_resource_sets.emplace_back(resource_set_result.Unwrap()).get();
+  return resource_set;
+}
+
 MGPUResult Queue::Flush() {
   // TODO: begin and submit command buffers on demand instead?
   MGPU_FORWARD_ERROR(SubmitCurrentCommandBuffer());
@@ -284,18 +551,36 @@ MGPUResult Queue::Flush() {
 }
 
 MGPUResult Queue::SubmitCurrentCommandBuffer() {
+  RecordPendingUploads();
+  MGPU_FORWARD_ERROR(m_transient_ring->FlushHostWrites());
+
   const VkPipelineStageFlags vk_wait_dst_stage_mask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
 
+  const u64 submission_index = GetLastSubmissionIndex() + 1u;
+
+  // The first signal semaphore is always the timeline semaphore. Binary semaphores ignore their signal value.
+  VkSemaphore vk_signal_semaphores[2]{m_vk_timeline_semaphore, VK_NULL_HANDLE};
+  const u64 signal_semaphore_values[2]{submission_index, 0u};
+
+  VkTimelineSemaphoreSubmitInfo vk_timeline_semaphore_submit_info{
+    .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+    .pNext = nullptr,
+    .waitSemaphoreValueCount = 0u,
+    .pWaitSemaphoreValues = nullptr,
+    .signalSemaphoreValueCount = 1u,
+    .pSignalSemaphoreValues = signal_semaphore_values
+  };
+
   VkSubmitInfo vk_submit_info{
     .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-    .pNext = nullptr,
+    .pNext = &vk_timeline_semaphore_submit_info,
     .waitSemaphoreCount = 0u,
     .pWaitSemaphores = nullptr,
     .pWaitDstStageMask = &vk_wait_dst_stage_mask,
     .commandBufferCount = 1u,
     .pCommandBuffers = &m_vk_cmd_buffer,
-    .signalSemaphoreCount = 0u,
-    .pSignalSemaphores = nullptr
+    .signalSemaphoreCount = 1u,
+    .pSignalSemaphores = vk_signal_semaphores
   };
 
   VkSemaphore vk_swap_chain_acquire_semaphore = m_vk_swap_chain_acquire_semaphore;
@@ -303,23 +588,26 @@ MGPUResult Queue::SubmitCurrentCommandBuffer() {
     vk_submit_info.waitSemaphoreCount = 1u;
     vk_submit_info.pWaitSemaphores = &vk_swap_chain_acquire_semaphore;
 
-    vk_submit_info.signalSemaphoreCount = 1u;
-    vk_submit_info.pSignalSemaphores = &vk_swap_chain_acquire_semaphore;
+    vk_signal_semaphores[1] = vk_swap_chain_acquire_semaphore;
+    vk_submit_info.signalSemaphoreCount = 2u;
+    vk_timeline_semaphore_submit_info.signalSemaphoreValueCount = 2u;
   }
 
   MGPU_VK_FORWARD_ERROR(vkEndCommandBuffer(m_vk_cmd_buffer));
-  MGPU_VK_FORWARD_ERROR(vkQueueSubmit(m_vk_queue, 1u, &vk_submit_info, m_vk_cmd_buffer_fence));
-  m_fenced_cmd_buffers[m_current_cmd_buffer].submitted = true;
-  m_fenced_cmd_buffers[m_current_cmd_buffer].timestamp_submitted = m_device->GetDeleterQueue().GetTimestamp();
-  m_device->GetDeleterQueue().BumpTimestamp();
-  m_current_cmd_buffer = (m_current_cmd_buffer + 1u) % m_fenced_cmd_buffers.size();
+  MGPU_VK_FORWARD_ERROR(vkQueueSubmit(m_vk_queue, 1u, &vk_submit_info, VK_NULL_HANDLE));
+  m_cmd_buffers[m_current_cmd_buffer].submission_index = submission_index;
+  m_cmd_buffers[m_current_cmd_buffer].staging_ring_head = m_staging_ring->GetHead();
+  m_cmd_buffers[m_current_cmd_buffer].transient_ring_head = m_transient_ring->GetHead();
+  m_last_submission_index.store(submission_index, std::memory_order_release);
+  m_deleter_queue->SetTimestamp(m_deleter_timeline, submission_index);
+  m_have_recorded_work = false;
+  m_current_cmd_buffer = (m_current_cmd_buffer + 1u) % m_cmd_buffers.size();
   return MGPU_SUCCESS;
 }
 
 MGPUResult Queue::BeginNextCommandBuffer() {
-  FencedCommandBuffer& fenced_cmd_buffer = m_fenced_cmd_buffers[m_current_cmd_buffer];
-  m_vk_cmd_buffer = fenced_cmd_buffer.vk_cmd_buffer;
-  m_vk_cmd_buffer_fence = fenced_cmd_buffer.vk_fence;
+  SubmittedCommandBuffer& cmd_buffer = m_cmd_buffers[m_current_cmd_buffer];
+  m_vk_cmd_buffer = cmd_buffer.vk_cmd_buffer;
 
   const VkCommandBufferBeginInfo vk_cmd_buffer_begin_info{
     .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
@@ -327,21 +615,23 @@ MGPUResult Queue::BeginNextCommandBuffer() {
     .flags = 0,
     .pInheritanceInfo = nullptr
   };
-  if(fenced_cmd_buffer.submitted) {
-    MGPU_VK_FORWARD_ERROR(vkWaitForFences(m_vk_device, 1u, &m_vk_cmd_buffer_fence, VK_TRUE, ~0ull));
-    MGPU_VK_FORWARD_ERROR(vkResetFences(m_vk_device, 1u, &m_vk_cmd_buffer_fence));
-    m_device->GetDeleterQueue().Drain(fenced_cmd_buffer.timestamp_submitted);
-    fenced_cmd_buffer.submitted = false;
+
+  // Only block if the GPU has not finished with the command buffer yet. Otherwise, reclaim whatever has completed so far.
+  MGPU_FORWARD_ERROR(WaitForSubmission(cmd_buffer.submission_index));
+  ReclaimCompletedSubmissions();
+
+  // Release the transient resource sets which were used by the previous submission of the command buffer.
+  cmd_buffer.transient_resource_sets.clear();
+  if(cmd_buffer.transient_descriptor_allocator != nullptr) {
+    MGPU_FORWARD_ERROR(cmd_buffer.transient_descriptor_allocator->Reset());
   }
+
   MGPU_VK_FORWARD_ERROR(vkResetCommandBuffer(m_vk_cmd_buffer, 0u));
   MGPU_VK_FORWARD_ERROR(vkBeginCommandBuffer(m_vk_cmd_buffer, &vk_cmd_buffer_begin_info));
   return MGPU_SUCCESS;
 }
 
-void Queue::HandleCmdBeginRenderPass(CommandListState& state, const BeginRenderPassCommand& command) {
-  const bool have_depth_stencil_attachment = command.m_have_depth_stencil_attachment;
-  const auto& depth_stencil_attachment = command.m_depth_stencil_attachment;
-
+RenderPassQuery Queue::GetRenderPassQuery(const BeginRenderPassCommand& command) {
   RenderPassQuery render_pass_query{};
 
   for(size_t i = 0; i < command.m_color_attachments.Size(); i++) {
@@ -351,109 +641,141 @@ void Queue::HandleCmdBeginRenderPass(CommandListState& state, const BeginRenderP
     }
   }
 
-  if(have_depth_stencil_attachment) {
+  if(command.m_have_depth_stencil_attachment) {
+    const auto& depth_stencil_attachment = command.m_depth_stencil_attachment;
     render_pass_query.SetDepthStencilAttachment(
       depth_stencil_attachment.texture_view->Format(),
       depth_stencil_attachment.depth_load_op, depth_stencil_attachment.depth_store_op,
       depth_stencil_attachment.stencil_load_op, depth_stencil_attachment.stencil_store_op);
   }
 
-  auto& pipeline_query = state.render_pass.pipeline_query;
-  VkRenderPass vk_render_pass = m_render_pass_cache->GetRenderPass(render_pass_query).Unwrap(); // TODO(fleroviux): handle failure
-  pipeline_query = {};
-  pipeline_query.m_vk_render_pass = vk_render_pass;
+  return render_pass_query;
+}
 
-  // Create a temporary framebuffer
-  atom::Vector_N<VkImageView, limits::max_total_attachments> vk_attachment_image_views{};
+MGPUExtent3D Queue::GetRenderPassExtent(const BeginRenderPassCommand& command) {
+  if(command.m_have_depth_stencil_attachment) {
+    return command.m_depth_stencil_attachment.texture_view->GetTexture()->Extent();
+  }
 
   for(const auto& color_attachment : command.m_color_attachments) {
-    const auto texture_view = (TextureView*)color_attachment.texture_view;
-    if(texture_view != nullptr) {
-      vk_attachment_image_views.PushBack(texture_view->Handle());
-      state.render_pass.color_attachments.PushBack(texture_view);
+    if(color_attachment.texture_view != nullptr) {
+      return color_attachment.texture_view->GetTexture()->Extent();
     }
   }
-  if(have_depth_stencil_attachment) {
-    const auto texture_view = (TextureView*)depth_stencil_attachment.texture_view;
-    vk_attachment_image_views.PushBack(texture_view->Handle());
-    state.render_pass.depth_stencil_attachment = texture_view;
-  }
 
-  MGPUExtent3D texture_dimensions;
+  return {};
+}
 
-  if(have_depth_stencil_attachment) {
-    texture_dimensions = depth_stencil_attachment.texture_view->GetTexture()->Extent();
-  } else {
-    for(const auto& color_attachment : command.m_color_attachments) {
-      if(color_attachment.texture_view != nullptr) {
-        texture_dimensions = color_attachment.texture_view->GetTexture()->Extent();
-        break;
-      }
-    }
-  }
+void Queue::SetDefaultViewportAndScissor(VkCommandBuffer vk_cmd_buffer, const MGPUExtent3D& extent) {
+  const VkViewport vk_viewport{
+    .x = 0.f,
+    .y = 0.f,
+    .width = (f32)extent.width,
+    .height = (f32)extent.height,
+    .minDepth = 0.f,
+    .maxDepth = 1.f
+  };
 
-  const VkFramebufferCreateInfo vk_framebuffer_create_info{
-    .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-    .pNext = nullptr,
-    .flags = 0,
-    .renderPass = vk_render_pass,
-    .attachmentCount = (u32)vk_attachment_image_views.Size(),
-    .pAttachments = vk_attachment_image_views.Data(),
-    .width = texture_dimensions.width,
-    .height = texture_dimensions.height,
-    .layers = 1u
+  const VkRect2D vk_scissor{
+    .offset = {.x = 0, .y = 0},
+    .extent = {.width = 0x7FFFFFFF, .height = 0x7FFFFFFF}
   };
 
-  VkFramebuffer vk_framebuffer{};
-  if(vkCreateFramebuffer(m_vk_device, &vk_framebuffer_create_info, nullptr, &vk_framebuffer) != VK_SUCCESS) {
-    // TODO(fleroviux): report error to user
-    ATOM_PANIC("failed to create VkFramebuffer");
-  }
+  vkCmdSetViewport(vk_cmd_buffer, 0u, 1u, &vk_viewport);
+  vkCmdSetScissor(vk_cmd_buffer, 0u, 1u, &vk_scissor);
+}
+
+MGPUResult Queue::HandleCmdBeginRenderPass(CommandListState& state, const BeginRenderPassCommand& command) {
+  const bool have_depth_stencil_attachment = command.m_have_depth_stencil_attachment;
+  const auto& depth_stencil_attachment = command.m_depth_stencil_attachment;
+
+  const RenderPassQuery render_pass_query = GetRenderPassQuery(command);
+  const MGPUExtent3D texture_dimensions = GetRenderPassExtent(command);
+
+  state.render_pass.pipeline_query = {};
 
-  // Begin the render pass
-  atom::Vector_N<VkClearValue, limits::max_total_attachments> vk_clear_values{};
   for(const auto& color_attachment : command.m_color_attachments) {
-    if(color_attachment.texture_view != nullptr) {
-      // TODO(fleroviux): implement code paths for unsigned and signed integer texture formats
-      vk_clear_values.PushBack({
-        .color = {
-          .float32 = {
-            (f32)color_attachment.clear_color.r,
-            (f32)color_attachment.clear_color.g,
-            (f32)color_attachment.clear_color.b,
-            (f32)color_attachment.clear_color.a
-          }
-        }
-      });
+    const auto texture_view = (TextureView*)color_attachment.texture_view;
+    if(texture_view != nullptr) {
+      state.render_pass.color_attachments.PushBack(texture_view);
 
-      ((Texture*)color_attachment.texture_view->GetTexture())->TransitionState({
+      ((Texture*)texture_view->GetTexture())->TransitionState({
         .m_image_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
         .m_access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
         .m_pipeline_stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
-      }, m_vk_cmd_buffer);
+      }, state.vk_cmd_buffer);
     }
   }
 
   if(have_depth_stencil_attachment) {
-    vk_clear_values.PushBack({
-      .depthStencil = {
-        .depth = depth_stencil_attachment.clear_depth,
-        .stencil = depth_stencil_attachment.clear_stencil
-      }
-    });
+    const auto texture_view = (TextureView*)depth_stencil_attachment.texture_view;
+    state.render_pass.depth_stencil_attachment = texture_view;
 
-    ((Texture*)depth_stencil_attachment.texture_view->GetTexture())->TransitionState({
+    ((Texture*)texture_view->GetTexture())->TransitionState({
       .m_image_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
       .m_access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
       .m_pipeline_stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
-    }, m_vk_cmd_buffer);
+    }, state.vk_cmd_buffer);
   }
 
+  if(m_use_dynamic_rendering) {
+    BeginRendering(state, command, render_pass_query, texture_dimensions);
+  } else {
+    MGPU_FORWARD_ERROR(BeginRenderPass(state, command, render_pass_query, texture_dimensions));
+  }
+
+  // The render pass only executes command bundles, which set up their own viewport and scissor test.
+  if(!command.m_have_command_bundles) {
+    // Set viewport and scissor test to sane defaults
+    SetDefaultViewportAndScissor(state.vk_cmd_buffer, texture_dimensions);
+  }
+  return MGPU_SUCCESS;
+}
+
+MGPUResult Queue::BeginRenderPass(CommandListState& state, const BeginRenderPassCommand& command, const RenderPassQuery& render_pass_query, const MGPUExtent3D& texture_dimensions) {
+  Result<VkRenderPass> vk_render_pass_result = m_render_pass_cache->GetRenderPass(render_pass_query);
+  MGPU_FORWARD_ERROR(vk_render_pass_result.Code());
+
+  Result<VkRenderPass> vk_compatible_render_pass_result = m_render_pass_cache->GetCompatibleRenderPass(render_pass_query);
+  MGPU_FORWARD_ERROR(vk_compatible_render_pass_result.Code());
+
+  VkRenderPass vk_render_pass = vk_render_pass_result.Unwrap();
+  VkRenderPass vk_compatible_render_pass = vk_compatible_render_pass_result.Unwrap();
+
+  // Pipelines only depend on the compatibility class of the render pass, so share them between all load and store operations.
+  state.render_pass.pipeline_query.m_vk_render_pass = vk_compatible_render_pass;
+
+  // Framebuffers are cached, too, so they are shared between all load and store operations as well.
+  FramebufferQuery framebuffer_query{
+    .m_vk_render_pass = vk_compatible_render_pass,
+    .m_width = texture_dimensions.width,
+    .m_height = texture_dimensions.height
+  };
+
+  atom::Vector_N<VkClearValue, limits::max_total_attachments> vk_clear_values{};
+
+  for(const auto& color_attachment : command.m_color_attachments) {
+    const auto texture_view = (TextureView*)color_attachment.texture_view;
+    if(texture_view != nullptr) {
+      framebuffer_query.m_vk_image_views.PushBack(texture_view->Handle());
+      vk_clear_values.PushBack(GetClearValue(color_attachment));
+    }
+  }
+
+  if(command.m_have_depth_stencil_attachment) {
+    const auto& depth_stencil_attachment = command.m_depth_stencil_attachment;
+    framebuffer_query.m_vk_image_views.PushBack(((TextureView*)depth_stencil_attachment.texture_view)->Handle());
+    vk_clear_values.PushBack(GetClearValue(depth_stencil_attachment));
+  }
+
+  Result<VkFramebuffer> vk_framebuffer_result = m_framebuffer_cache->GetFramebuffer(framebuffer_query);
+  MGPU_FORWARD_ERROR(vk_framebuffer_result.Code());
+
   const VkRenderPassBeginInfo vk_render_pass_begin_info{
     .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
     .pNext = nullptr,
     .renderPass = vk_render_pass,
-    .framebuffer = vk_framebuffer,
+    .framebuffer = vk_framebuffer_result.Unwrap(),
     .renderArea = {
       .offset = { .x = 0, .y = 0 },
       .extent = { .width = texture_dimensions.width, .height = texture_dimensions.height }
@@ -461,40 +783,122 @@ void Queue::HandleCmdBeginRenderPass(CommandListState& state, const BeginRenderP
     .clearValueCount = (u32)vk_clear_values.Size(),
     .pClearValues = vk_clear_values.Data()
   };
-  vkCmdBeginRenderPass(m_vk_cmd_buffer, &vk_render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
-  // Set viewport and scissor test to sane defaults
-  const VkViewport vk_viewport{
-    .x = 0.f,
-    .y = 0.f,
-    .width = (f32)texture_dimensions.width,
-    .height = (f32)texture_dimensions.height,
-    .minDepth = 0.f,
-    .maxDepth = 1.f
-  };
+  const VkSubpassContents vk_subpass_contents = command.m_have_command_bundles ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+  vkCmdBeginRenderPass(state.vk_cmd_buffer, &vk_render_pass_begin_info, vk_subpass_contents);
+  return MGPU_SUCCESS;
+}
 
-  const VkRect2D vk_scissor{
-    .offset = {.x = 0, .y = 0},
-    .extent = {.width = 0x7FFFFFFF, .height = 0x7FFFFFFF}
+void Queue::BeginRendering(CommandListState& state, const BeginRenderPassCommand& command, const RenderPassQuery& render_pass_query, const MGPUExtent3D& texture_dimensions) {
+  const RenderTargetFormats render_target_formats = render_pass_query.GetRenderTargetFormats();
+
+  state.render_pass.pipeline_query.m_render_target_formats = render_target_formats;
+
+  // The attachment indices must match the pipelines, so unused color attachments are passed with a null image view.
+  atom::Vector_N<VkRenderingAttachmentInfo, limits::max_color_attachments> vk_color_attachments{};
+
+  for(size_t i = 0; i < render_target_formats.ColorAttachmentCount(); i++) {
+    const auto& color_attachment = command.m_color_attachments[i];
+    const auto texture_view = (TextureView*)color_attachment.texture_view;
+
+    vk_color_attachments.PushBack({
+      .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+      .pNext = nullptr,
+      .imageView = texture_view != nullptr ? texture_view->Handle() : VK_NULL_HANDLE,
+      .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+      .resolveMode = VK_RESOLVE_MODE_NONE,
+      .resolveImageView = VK_NULL_HANDLE,
+      .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      .loadOp = MGPULoadOpToVkAttachmentLoadOp(color_attachment.load_op),
+      .storeOp = MGPUStoreOpToVkAttachmentStoreOp(color_attachment.store_op),
+      .clearValue = GetClearValue(color_attachment)
+    });
+  }
+
+  VkRenderingAttachmentInfo vk_depth_attachment{};
+  VkRenderingAttachmentInfo vk_stencil_attachment{};
+
+  if(command.m_have_depth_stencil_attachment) {
+    const auto& depth_stencil_attachment = command.m_depth_stencil_attachment;
+
+    vk_depth_attachment = {
+      .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+      .pNext = nullptr,
+      .imageView = ((TextureView*)depth_stencil_attachment.texture_view)->Handle(),
+      .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+      .resolveMode = VK_RESOLVE_MODE_NONE,
+      .resolveImageView = VK_NULL_HANDLE,
+      .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      .loadOp = MGPULoadOpToVkAttachmentLoadOp(depth_stencil_attachment.depth_load_op),
+      .storeOp = MGPUStoreOpToVkAttachmentStoreOp(depth_stencil_attachment.depth_store_op),
+      .clearValue = GetClearValue(depth_stencil_attachment)
+    };
+
+    vk_stencil_attachment = vk_depth_attachment;
+    vk_stencil_attachment.loadOp = MGPULoadOpToVkAttachmentLoadOp(depth_stencil_attachment.stencil_load_op);
+    vk_stencil_attachment.storeOp = MGPUStoreOpToVkAttachmentStoreOp(depth_stencil_attachment.stencil_store_op);
+  }
+
+  const VkRenderingInfo vk_rendering_info{
+    .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+    .pNext = nullptr,
+    .flags = command.m_have_command_bundles ? (VkRenderingFlags)VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0u,
+    .renderArea = {
+      .offset = { .x = 0, .y = 0 },
+      .extent = { .width = texture_dimensions.width, .height = texture_dimensions.height }
+    },
+    .layerCount = 1u,
+    .viewMask = 0u,
+    .colorAttachmentCount = (u32)vk_color_attachments.Size(),
+    .pColorAttachments = vk_color_attachments.Data(),
+    .pDepthAttachment = render_target_formats.m_vk_depth_format != VK_FORMAT_UNDEFINED ? &vk_depth_attachment : nullptr,
+    .pStencilAttachment = render_target_formats.m_vk_stencil_format != VK_FORMAT_UNDEFINED ? &vk_stencil_attachment : nullptr
   };
+  vkCmdBeginRendering(state.vk_cmd_buffer, &vk_rendering_info);
+}
 
-  vkCmdSetViewport(m_vk_cmd_buffer, 0u, 1u, &vk_viewport);
-  vkCmdSetScissor(m_vk_cmd_buffer, 0u, 1u, &vk_scissor);
+VkClearValue Queue::GetClearValue(const BeginRenderPassCommand::ColorAttachment& color_attachment) {
+  // TODO(fleroviux): implement code paths for unsigned and signed integer texture formats
+  return {
+    .color = {
+      .float32 = {
+        (f32)color_attachment.clear_color.r,
+        (f32)color_attachment.clear_color.g,
+        (f32)color_attachment.clear_color.b,
+        (f32)color_attachment.clear_color.a
+      }
+    }
+  };
+}
 
-  // Destroy temporary framebuffer at the end of the frame.
-  VkDevice vk_device = m_vk_device;
-  m_deleter_queue->Schedule([vk_device, vk_framebuffer]() {
-    vkDestroyFramebuffer(vk_device, vk_framebuffer, nullptr);
-  });
+VkClearValue Queue::GetClearValue(const BeginRenderPassCommand::DepthStencilAttachment& depth_stencil_attachment) {
+  return {
+    .depthStencil = {
+      .depth = depth_stencil_attachment.clear_depth,
+      .stencil = depth_stencil_attachment.clear_stencil
+    }
+  };
 }
 
 void Queue::HandleCmdEndRenderPass(CommandListState& state) {
-  vkCmdEndRenderPass(m_vk_cmd_buffer);
+  if(m_use_dynamic_rendering) {
+    vkCmdEndRendering(state.vk_cmd_buffer);
+  } else {
+    vkCmdEndRenderPass(state.vk_cmd_buffer);
+  }
 
   state.render_pass = {};
 }
 
 void Queue::HandleCmdUseShaderProgram(CommandListState& state, const UseShaderProgramCommand& command) {
+  if(state.inside_compute_pass) {
+    if(state.compute_pass.shader_program != command.m_shader_program) {
+      state.compute_pass.shader_program = (const ShaderProgram*)command.m_shader_program;
+      state.compute_pass.require_pipeline_switch = true;
+    }
+    return;
+  }
+
   GraphicsPipelineQuery& pipeline_query = state.render_pass.pipeline_query;
 
   if(pipeline_query.m_shader_program != command.m_shader_program) {
@@ -558,8 +962,7 @@ void Queue::HandleCmdSetViewport(CommandListState& state, const SetViewportComma
     .maxDepth = 1.f
   };
 
-  (void)state;
-  vkCmdSetViewport(m_vk_cmd_buffer, 0u, 1u, &vk_viewport);
+  vkCmdSetViewport(state.vk_cmd_buffer, 0u, 1u, &vk_viewport);
 }
 
 void Queue::HandleCmdSetScissor(CommandListState& state, const SetScissorCommand& command) {
@@ -574,46 +977,161 @@ void Queue::HandleCmdSetScissor(CommandListState& state, const SetScissorCommand
     }
   };
 
-  (void)state;
-  vkCmdSetScissor(m_vk_cmd_buffer, 0u, 1u, &vk_scissor_rect);
+  vkCmdSetScissor(state.vk_cmd_buffer, 0u, 1u, &vk_scissor_rect);
 }
 
 void Queue::HandleCmdBindVertexBuffer(CommandListState& state, const BindVertexBufferCommand& command) {
   const auto buffer = (Buffer*)command.m_buffer;
   // TODO(fleroviux): this breaks since we're inside of a render pass already. How to fix?
-  //buffer->TransitionState({VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT}, m_vk_cmd_buffer);
+  //buffer->TransitionState({VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT}, state.vk_cmd_buffer);
 
   VkBuffer vk_buffer = buffer->Handle();
-  vkCmdBindVertexBuffers(m_vk_cmd_buffer, command.m_binding, 1u, &vk_buffer, &command.m_buffer_offset);
+  vkCmdBindVertexBuffers(state.vk_cmd_buffer, command.m_binding, 1u, &vk_buffer, &command.m_buffer_offset);
 }
 
 void Queue::HandleCmdBindIndexBuffer(CommandListState& state, const BindIndexBufferCommand& command) {
   // TODO(fleroviux): implement a resource barrier
-  vkCmdBindIndexBuffer(m_vk_cmd_buffer, ((Buffer*)command.m_buffer)->Handle(), command.m_buffer_offset, MGPUIndexFormatToVkIndexType(command.m_index_format));
+  vkCmdBindIndexBuffer(state.vk_cmd_buffer, ((Buffer*)command.m_buffer)->Handle(), command.m_buffer_offset, MGPUIndexFormatToVkIndexType(command.m_index_format));
 }
 
 void Queue::HandleCmdBindResourceSet(CommandListState& state, const BindResourceSetCommand& command) {
-  const auto vk_pipeline_layout = state.render_pass.pipeline_query.m_shader_program->GetVkPipelineLayout();
-  const auto vk_descriptor_set = ((ResourceSet*)command.m_resource_set)->Handle();
+  const ShaderProgram* shader_program = state.inside_compute_pass ? state.compute_pass.shader_program : state.render_pass.pipeline_query.m_shader_program;
+  const VkPipelineBindPoint vk_pipeline_bind_point = state.inside_compute_pass ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+  const auto resource_set = (ResourceSet*)command.m_resource_set;
+  const auto vk_pipeline_layout = shader_program->GetVkPipelineLayout();
+  const auto vk_descriptor_set = resource_set->Handle();
+
+  // Layout transitions cannot be recorded inside of a render pass, so only compute passes can transition storage textures.
   // TODO(fleroviux): transition resources bound to the resource set to their required states
-  vkCmdBindDescriptorSets(m_vk_cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipeline_layout, command.m_index, 1u, &vk_descriptor_set, 0u, nullptr);
+  if(state.inside_compute_pass) {
+    for(Texture* texture : resource_set->GetStorageTextures()) {
+      texture->TransitionState({
+        .m_image_layout = VK_IMAGE_LAYOUT_GENERAL,
+        .m_access = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .m_pipeline_stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+      }, state.vk_cmd_buffer);
+    }
+  }
+
+  const std::span<const u32> dynamic_offsets = command.DynamicOffsets();
+  vkCmdBindDescriptorSets(
+    state.vk_cmd_buffer, vk_pipeline_bind_point, vk_pipeline_layout, command.m_index, 1u, &vk_descriptor_set, (u32)dynamic_offsets.size(), dynamic_offsets.data());
+}
+
+void Queue::HandleCmdPushConstants(CommandListState& state, const PushConstantsCommand& command) {
+  const ShaderProgram* shader_program = state.inside_compute_pass ? state.compute_pass.shader_program : state.render_pass.pipeline_query.m_shader_program;
+  const VkShaderStageFlags vk_shader_stages = MGPUShaderStagesToVkShaderStageFlags(command.m_stages);
+  vkCmdPushConstants(state.vk_cmd_buffer, shader_program->GetVkPipelineLayout(), vk_shader_stages, command.m_offset, command.m_size, command.Data());
 }
 
 void Queue::HandleCmdDraw(CommandListState& state, const DrawCommand& command) {
-  BindGraphicsPipelineForCurrentState(state);
-  vkCmdDraw(m_vk_cmd_buffer, command.m_vertex_count, command.m_instance_count, command.m_first_vertex, command.m_first_instance);
+  if(!BindGraphicsPipelineForCurrentState(state)) {
+    return;
+  }
+  vkCmdDraw(state.vk_cmd_buffer, command.m_vertex_count, command.m_instance_count, command.m_first_vertex, command.m_first_instance);
 }
 
 void Queue::HandleCmdDrawIndexed(CommandListState& state, const DrawIndexedCommand& command) {
-  BindGraphicsPipelineForCurrentState(state);
-  vkCmdDrawIndexed(m_vk_cmd_buffer, command.m_index_count, command.m_instance_count, command.m_first_index, command.m_vertex_offset, command.m_first_instance);
+  if(!BindGraphicsPipelineForCurrentState(state)) {
+    return;
+  }
+  vkCmdDrawIndexed(state.vk_cmd_buffer, command.m_index_count, command.m_instance_count, command.m_first_index, command.m_vertex_offset, command.m_first_instance);
 }
 
-void Queue::BindGraphicsPipelineForCurrentState(CommandListState& state) {
-  if(!state.render_pass.require_pipeline_switch) {
+void Queue::HandleCmdDrawIndirect(CommandListState& state, const DrawIndirectCommand& command) {
+  if(!BindGraphicsPipelineForCurrentState(state)) {
     return;
   }
-  state.render_pass.require_pipeline_switch = false;
+
+  const VkBuffer vk_buffer = ((Buffer*)command.m_buffer)->Handle();
+
+  if(command.m_count_buffer != nullptr) {
+    const VkBuffer vk_count_buffer = ((Buffer*)command.m_count_buffer)->Handle();
+    vkCmdDrawIndirectCount(state.vk_cmd_buffer, vk_buffer, command.m_buffer_offset, vk_count_buffer, command.m_count_buffer_offset, command.m_draw_count, command.m_stride);
+  } else {
+    vkCmdDrawIndirect(state.vk_cmd_buffer, vk_buffer, command.m_buffer_offset, command.m_draw_count, command.m_stride);
+  }
+}
+
+void Queue::HandleCmdDrawIndexedIndirect(CommandListState& state, const DrawIndexedIndirectCommand& command) {
+  if(!BindGraphicsPipelineForCurrentState(state)) {
+    return;
+  }
+
+  const VkBuffer vk_buffer = ((Buffer*)command.m_buffer)->Handle();
+
+  if(command.m_count_buffer != nullptr) {
+    const VkBuffer vk_count_buffer = ((Buffer*)command.m_count_buffer)->Handle();
+    vkCmdDrawIndexedIndirectCount(state.vk_cmd_buffer, vk_buffer, command.m_buffer_offset, vk_count_buffer, command.m_count_buffer_offset, command.m_draw_count, command.m_stride);
+  } else {
+    vkCmdDrawIndexedIndirect(state.vk_cmd_buffer, vk_buffer, command.m_buffer_offset, command.m_draw_count, command.m_stride);
+  }
+}
+
+void Queue::HandleCmdExecuteCommandBundle(CommandListState& state, const ExecuteCommandBundleCommand& command) {
+  const VkCommandBuffer vk_cmd_buffer = ((const CommandBundle*)command.m_command_bundle)->Handle();
+  vkCmdExecuteCommands(state.vk_cmd_buffer, 1u, &vk_cmd_buffer);
+
+  // The bound pipeline is undefined after executing secondary command buffers.
+  state.render_pass.vk_bound_pipeline = VK_NULL_HANDLE;
+  state.render_pass.require_pipeline_switch = true;
+}
+
+void Queue::HandleCmdBeginComputePass(CommandListState& state) {
+  state.inside_compute_pass = true;
+  state.compute_pass = {};
+
+  // Resource sets do not track their resources yet, so make all prior writes visible to the compute pass with a global memory barrier.
+  RecordMemoryBarrier(
+    state.vk_cmd_buffer,
+    VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+    VK_ACCESS_MEMORY_WRITE_BIT,
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+  );
+}
+
+void Queue::HandleCmdEndComputePass(CommandListState& state) {
+  if(state.compute_pass.have_pending_writes) {
+    // ALL_COMMANDS is used, because the queue may not support graphics stages.
+    RecordMemoryBarrier(
+      state.vk_cmd_buffer,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_WRITE_BIT,
+      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+      VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT
+    );
+  }
+
+  state.inside_compute_pass = false;
+  state.compute_pass = {};
+}
+
+void Queue::HandleCmdDispatch(CommandListState& state, const DispatchCommand& command) {
+  WaitForPendingComputeWrites(state);
+
+  if(!BindComputePipelineForCurrentState(state)) {
+    return;
+  }
+  vkCmdDispatch(state.vk_cmd_buffer, command.m_group_count_x, command.m_group_count_y, command.m_group_count_z);
+  state.compute_pass.have_pending_writes = true;
+}
+
+void Queue::HandleCmdDispatchIndirect(CommandListState& state, const DispatchIndirectCommand& command) {
+  WaitForPendingComputeWrites(state);
+
+  if(!BindComputePipelineForCurrentState(state)) {
+    return;
+  }
+  vkCmdDispatchIndirect(state.vk_cmd_buffer, ((Buffer*)command.m_buffer)->Handle(), command.m_buffer_offset);
+  state.compute_pass.have_pending_writes = true;
+}
+
+bool Queue::BindGraphicsPipelineForCurrentState(CommandListState& state) {
+  if(!state.render_pass.require_pipeline_switch) {
+    return true;
+  }
 
   const GraphicsPipelineQuery& pipeline_query = state.render_pass.pipeline_query;
 
@@ -626,12 +1144,188 @@ void Queue::BindGraphicsPipelineForCurrentState(CommandListState& state) {
       && pipeline_query.m_vertex_input_state != nullptr;
 
   if(!pipeline_complete) {
-    return;
+    state.render_pass.require_pipeline_switch = false;
+    return true;
+  }
+
+  // Fast path: the pipeline for the query is bound already, for example because a state has been changed and then changed back.
+  if(state.render_pass.vk_bound_pipeline != VK_NULL_HANDLE && pipeline_query == state.render_pass.bound_pipeline_query) {
+    state.render_pass.require_pipeline_switch = false;
+    return true;
+  }
+
+  const size_t pipeline_query_hash = GraphicsPipelineQuery::Hasher{}(pipeline_query);
+
+  GraphicsPipelineCache::PipelinePin pipeline_pin{};
+  Result<VkPipeline> vk_pipeline_result = m_graphics_pipeline_cache->GetPipeline(
+    pipeline_query, pipeline_query_hash, state.wait_for_pipelines, state.pipeline_pins != nullptr ? &pipeline_pin : nullptr);
+
+  if(vk_pipeline_result.Code() == MGPU_NOT_READY) {
+    // The pipeline is still being compiled. Use the fallback shader program if there is one, otherwise skip the draw.
+    // The pipeline switch stays pending, so that the next draw checks again whether the pipeline has become ready.
+    ShaderProgram* fallback_shader_program = m_device->GetFallbackShaderProgram();
+    if(fallback_shader_program == nullptr) {
+      return false;
+    }
+
+    GraphicsPipelineQuery fallback_pipeline_query = pipeline_query;
+    fallback_pipeline_query.m_shader_program = fallback_shader_program;
+
+    Result<VkPipeline> vk_fallback_pipeline_result = m_graphics_pipeline_cache->GetPipeline(
+      fallback_pipeline_query, GraphicsPipelineQuery::Hasher{}(fallback_pipeline_query), true, state.pipeline_pins != nullptr ? &pipeline_pin : nullptr);
+    if(vk_fallback_pipeline_result.Code() != MGPU_SUCCESS) {
+      return false;
+    }
+    if(pipeline_pin) {
+      state.pipeline_pins->push_back(std::move(pipeline_pin));
+    }
+    state.render_pass.vk_bound_pipeline = VK_NULL_HANDLE;
+    vkCmdBindPipeline(state.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_fallback_pipeline_result.Unwrap());
+    return true;
+  }
+
+  if(pipeline_pin) {
+    state.pipeline_pins->push_back(std::move(pipeline_pin));
   }
 
   // TODO(fleroviux): handle failure to create the graphics pipeline.
-  Result<VkPipeline> vk_pipeline_result = m_graphics_pipeline_cache.GetPipeline(pipeline_query);
-  vkCmdBindPipeline(m_vk_cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipeline_result.Unwrap());
+  state.render_pass.require_pipeline_switch = false;
+  state.render_pass.bound_pipeline_query = pipeline_query;
+  state.render_pass.vk_bound_pipeline = vk_pipeline_result.Unwrap();
+  vkCmdBindPipeline(state.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, state.render_pass.vk_bound_pipeline);
+  return true;
+}
+
+bool Queue::BindComputePipelineForCurrentState(CommandListState& state) {
+  if(!state.compute_pass.require_pipeline_switch) {
+    return true;
+  }
+
+  Result<VkPipeline> vk_pipeline_result = m_compute_pipeline_cache->GetPipeline(state.compute_pass.shader_program);
+  if(vk_pipeline_result.Code() != MGPU_SUCCESS) {
+    return false;
+  }
+
+  state.compute_pass.require_pipeline_switch = false;
+  vkCmdBindPipeline(state.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, vk_pipeline_result.Unwrap());
+  return true;
+}
+
+void Queue::WaitForPendingComputeWrites(CommandListState& state) {
+  if(!state.compute_pass.have_pending_writes) {
+    return;
+  }
+
+  // Dispatches within a compute pass may consume the results of previous dispatches, either as storage resources or as indirect arguments.
+  RecordMemoryBarrier(
+    state.vk_cmd_buffer,
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+    VK_ACCESS_SHADER_WRITE_BIT,
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+  );
+  state.compute_pass.have_pending_writes = false;
+}
+
+void Queue::RecordMemoryBarrier(
+  VkCommandBuffer vk_cmd_buffer,
+  VkPipelineStageFlags vk_src_stage_mask,
+  VkAccessFlags vk_src_access_mask,
+  VkPipelineStageFlags vk_dst_stage_mask,
+  VkAccessFlags vk_dst_access_mask
+) {
+  const VkMemoryBarrier vk_memory_barrier{
+    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    .pNext = nullptr,
+    .srcAccessMask = vk_src_access_mask,
+    .dstAccessMask = vk_dst_access_mask
+  };
+  vkCmdPipelineBarrier(vk_cmd_buffer, vk_src_stage_mask, vk_dst_stage_mask, 0, 1u, &vk_memory_barrier, 0u, nullptr, 0u, nullptr);
+}
+
+void Queue::RecordPendingUploads() {
+  for(auto& [buffer, pending_uploads] : m_pending_buffer_uploads) {
+    RecordPendingBufferUploads(buffer, pending_uploads);
+  }
+  m_pending_buffer_uploads.clear();
+
+  for(auto& [texture, pending_uploads] : m_pending_texture_uploads) {
+    RecordPendingTextureUploads(texture, pending_uploads);
+  }
+  m_pending_texture_uploads.clear();
+}
+
+void Queue::RecordPendingBufferUploads(Buffer* buffer, PendingBufferUploads& pending_uploads) {
+  std::vector<VkBufferCopy>& vk_buffer_copies = pending_uploads.vk_buffer_copies;
+
+  if(vk_buffer_copies.empty()) {
+    return;
+  }
+
+  // Bring the buffer into a state where it's safe to copy to
+  buffer->TransitionState({VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT}, m_vk_cmd_buffer);
+
+  vkCmdCopyBuffer(m_vk_cmd_buffer, pending_uploads.vk_staging_buffer, buffer->Handle(), (u32)vk_buffer_copies.size(), vk_buffer_copies.data());
+  vk_buffer_copies.clear();
+}
+
+void Queue::RecordPendingTextureUploads(Texture* texture, PendingTextureUploads& pending_uploads) {
+  std::vector<VkBufferImageCopy>& vk_buffer_image_copies = pending_uploads.vk_buffer_image_copies;
+
+  if(vk_buffer_image_copies.empty()) {
+    return;
+  }
+
+  texture->TransitionState({
+    .m_image_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    .m_access = VK_ACCESS_TRANSFER_WRITE_BIT,
+    .m_pipeline_stages = VK_PIPELINE_STAGE_TRANSFER_BIT
+  }, m_vk_cmd_buffer);
+
+  vkCmdCopyBufferToImage(
+    m_vk_cmd_buffer, pending_uploads.vk_staging_buffer, texture->Handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    (u32)vk_buffer_image_copies.size(), vk_buffer_image_copies.data());
+  vk_buffer_image_copies.clear();
+}
+
+bool Queue::TextureRegionsOverlap(const VkBufferImageCopy& a, const VkBufferImageCopy& b) {
+  const auto RangesOverlap = [](i64 a_begin, i64 a_size, i64 b_begin, i64 b_size) {
+    return a_begin < b_begin + b_size && b_begin < a_begin + a_size;
+  };
+
+  return a.imageSubresource.mipLevel == b.imageSubresource.mipLevel &&
+    RangesOverlap(a.imageSubresource.baseArrayLayer, a.imageSubresource.layerCount, b.imageSubresource.baseArrayLayer, b.imageSubresource.layerCount) &&
+    RangesOverlap(a.imageOffset.x, a.imageExtent.width, b.imageOffset.x, b.imageExtent.width) &&
+    RangesOverlap(a.imageOffset.y, a.imageExtent.height, b.imageOffset.y, b.imageExtent.height) &&
+    RangesOverlap(a.imageOffset.z, a.imageExtent.depth, b.imageOffset.z, b.imageExtent.depth);
+}
+
+void Queue::ReclaimCompletedSubmissions() {
+  const u64 completed_submission_index = GetCompletedSubmissionIndex();
+
+  if(completed_submission_index == m_reclaimed_submission_index) {
+    return;
+  }
+
+  if(m_drains_deleter_queue) {
+    m_deleter_queue->Drain();
+  }
+
+  // Staging and transient memory is allocated linearly, so releasing up to the head of the most recent completed submission is enough.
+  const SubmittedCommandBuffer* latest_completed_cmd_buffer = nullptr;
+  for(const auto& cmd_buffer : m_cmd_buffers) {
+    if(cmd_buffer.submission_index != 0u && cmd_buffer.submission_index <= completed_submission_index &&
+       (latest_completed_cmd_buffer == nullptr || cmd_buffer.submission_index > latest_completed_cmd_buffer->submission_index)) {
+      latest_completed_cmd_buffer = &cmd_buffer;
+    }
+  }
+
+  if(latest_completed_cmd_buffer != nullptr && m_staging_ring) {
+    m_staging_ring->Release(latest_completed_cmd_buffer->staging_ring_head);
+    m_transient_ring->Release(latest_completed_cmd_buffer->transient_ring_head);
+  }
+
+  m_reclaimed_submission_index = completed_submission_index;
 }
 
 void Queue::DestroySwapChainAcquireSemaphore() {
@@ -646,4 +1340,12 @@ void Queue::DestroySwapChainAcquireSemaphore() {
   }
 }
 
+void Queue::MarkRecordedWork() {
+  // Resources which are destroyed from now on may be referenced by the command buffer that is being recorded.
+  if(!m_have_recorded_work) {
+    m_have_recorded_work = true;
+    m_deleter_queue->SetTimestamp(m_deleter_timeline, GetLastSubmissionIndex() + 1u);
+  }
+}
+
 }  // namespace mgpu::vulkan
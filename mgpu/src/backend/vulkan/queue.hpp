@@ -3,7 +3,9 @@
 
 #include <atom/integer.hpp>
 #include <atom/vector_n.hpp>
+#include <atomic>
 #include <memory>
+#include <unordered_map>
 #include <vulkan/vulkan.h>
 #include <vector>
 
@@ -11,13 +13,19 @@
 #include "backend/queue.hpp"
 #include "common/result.hpp"
 #include "common/limits.hpp"
+#include "compute_pipeline_cache.hpp"
 #include "deleter_queue.hpp"
+#include "descriptor_allocator.hpp"
+#include "framebuffer_cache.hpp"
 #include "graphics_pipeline_cache.hpp"
 #include "render_pass_cache.hpp"
+#include "staging_ring.hpp"
 
 namespace mgpu::vulkan {
 
+class Buffer;
 class Device;
+class Texture;
 class TextureView;
 class ShaderProgram;
 class RasterizerState;
@@ -25,6 +33,7 @@ class InputAssemblyState;
 class ColorBlendState;
 class VertexInputState;
 class SwapChain;
+class ResourceSet;
 
 class Queue final : public QueueBase {
   public:
@@ -34,48 +43,128 @@ class Queue final : public QueueBase {
       VkDevice vk_device,
       u32 queue_family_index,
       std::shared_ptr<DeleterQueue> deleter_queue,
-      std::shared_ptr<RenderPassCache> render_pass_cache
+      std::shared_ptr<RenderPassCache> render_pass_cache,
+      std::shared_ptr<FramebufferCache> framebuffer_cache,
+      std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache,
+      std::shared_ptr<ComputePipelineCache> compute_pipeline_cache,
+      bool use_dynamic_rendering,
+      bool drains_deleter_queue
     );
 
+    [[nodiscard]] u32 GetQueueFamilyIndex() const { return m_queue_family_index; }
+
+    /**
+     * Every submission signals the next value of the queue's timeline semaphore.
+     * These may be called from any thread to check the progress of the GPU.
+     */
+    [[nodiscard]] u64 GetLastSubmissionIndex() const { return m_last_submission_index.load(std::memory_order_acquire); }
+    [[nodiscard]] u64 GetCompletedSubmissionIndex();
+    [[nodiscard]] bool IsSubmissionComplete(u64 submission_index);
+    MGPUResult WaitForSubmission(u64 submission_index);
+
     void SetDevice(Device* device);
     void SetSwapChainAcquireSemaphore(VkSemaphore vk_swap_chain_acquire_semaphore);
     MGPUResult Present(SwapChain* swap_chain, u32 texture_index);
 
     MGPUResult SubmitCommandList(const CommandList* command_list) override;
+
+    /// The pipelines which the bundle has been recorded with are pinned, so that they are not evicted for as long as the bundle exists.
+    MGPUResult RecordCommandBundle(VkCommandBuffer vk_cmd_buffer, const CommandList* command_list, std::vector<GraphicsPipelineCache::PipelinePin>& pipeline_pins);
     MGPUResult BufferUpload(const BufferBase* buffer, std::span<const u8> data, u64 offset) override;
     MGPUResult TextureUpload(const TextureBase* texture, const MGPUTextureUploadRegion& region, const void* data) override;
+    Result<TransientAllocation> AllocateTransient(u64 size, u64 alignment, MGPUBufferUsage usage) override;
+    Result<ResourceSetBase*> CreateTransientResourceSet(const MGPUResourceSetCreateInfo& create_info) override;
     MGPUResult Flush() override;
 
+    void DiscardPendingUploads(const Buffer* buffer);
+    void DiscardPendingUploads(const Texture* texture);
+
   private:
-    struct FencedCommandBuffer {
+    struct SubmittedCommandBuffer {
       VkCommandBuffer vk_cmd_buffer{};
-      VkFence vk_fence{};
-      bool submitted{false};
-      u64 timestamp_submitted{};
+      u64 submission_index{}; // Zero if the command buffer has never been submitted.
+      u64 staging_ring_head{};
+      u64 transient_ring_head{};
+
+      // Released all at once when the command buffer is reused. The allocator is created on first use.
+      std::unique_ptr<TransientDescriptorAllocator> transient_descriptor_allocator{};
+      std::vector<std::unique_ptr<ResourceSet>> transient_resource_sets{};
     };
 
     Queue(
       VkDevice vk_device,
       VkQueue vk_queue,
+      u32 queue_family_index,
       VkCommandPool vk_cmd_pool,
-      std::vector<FencedCommandBuffer> fenced_cmd_buffers,
+      std::vector<SubmittedCommandBuffer> cmd_buffers,
+      VkSemaphore vk_timeline_semaphore,
       std::shared_ptr<DeleterQueue> deleter_queue,
-      std::shared_ptr<RenderPassCache> render_pass_cache
+      u32 deleter_timeline,
+      std::shared_ptr<RenderPassCache> render_pass_cache,
+      std::shared_ptr<FramebufferCache> framebuffer_cache,
+      std::shared_ptr<GraphicsPipelineCache> graphics_pipeline_cache,
+      std::shared_ptr<ComputePipelineCache> compute_pipeline_cache,
+      bool use_dynamic_rendering,
+      bool drains_deleter_queue
     );
 
     struct CommandListState {
+      VkCommandBuffer vk_cmd_buffer{};
+
+      // Set when draws must not be skipped because of pipelines which are still being compiled, for example when recording a command bundle.
+      bool wait_for_pipelines{};
+
+      // Receives pins for all graphics pipelines that are bound, if not null.
+      std::vector<GraphicsPipelineCache::PipelinePin>* pipeline_pins{};
+
       struct RenderPass {
         atom::Vector_N<TextureView*, limits::max_color_attachments> color_attachments{};
         TextureView* depth_stencil_attachment{};
         GraphicsPipelineQuery pipeline_query{};
         bool require_pipeline_switch{true};
+
+        // The pipeline that is currently bound, so that switching back to it does not require a pipeline cache lookup.
+        GraphicsPipelineQuery bound_pipeline_query{};
+        VkPipeline vk_bound_pipeline{};
       } render_pass{};
+
+      bool inside_compute_pass{};
+
+      struct ComputePass {
+        const ShaderProgram* shader_program{};
+        bool require_pipeline_switch{true};
+
+        // Set when a dispatch may have written to storage resources which are not yet visible to the following commands.
+        bool have_pending_writes{};
+      } compute_pass{};
+    };
+
+    struct PendingBufferUploads {
+      VkBuffer vk_staging_buffer{};
+      std::vector<VkBufferCopy> vk_buffer_copies{};
+    };
+
+    struct PendingTextureUploads {
+      VkBuffer vk_staging_buffer{};
+      std::vector<VkBufferImageCopy> vk_buffer_image_copies{};
     };
 
     MGPUResult SubmitCurrentCommandBuffer();
     MGPUResult BeginNextCommandBuffer();
 
-    void HandleCmdBeginRenderPass(CommandListState& state, const BeginRenderPassCommand& command);
+    MGPUResult RecordCommandList(CommandListState& state, const CommandList* command_list);
+    static void TransitionIndirectBuffers(CommandListState& state, CommandList::ConstIterator command_iterator);
+    MGPUResult HandleCommand(CommandListState& state, const CommandBase& command);
+
+    static RenderPassQuery GetRenderPassQuery(const BeginRenderPassCommand& command);
+    static MGPUExtent3D GetRenderPassExtent(const BeginRenderPassCommand& command);
+    static void SetDefaultViewportAndScissor(VkCommandBuffer vk_cmd_buffer, const MGPUExtent3D& extent);
+
+    MGPUResult HandleCmdBeginRenderPass(CommandListState& state, const BeginRenderPassCommand& command);
+    MGPUResult BeginRenderPass(CommandListState& state, const BeginRenderPassCommand& command, const RenderPassQuery& render_pass_query, const MGPUExtent3D& texture_dimensions);
+    void BeginRendering(CommandListState& state, const BeginRenderPassCommand& command, const RenderPassQuery& render_pass_query, const MGPUExtent3D& texture_dimensions);
+    static VkClearValue GetClearValue(const BeginRenderPassCommand::ColorAttachment& color_attachment);
+    static VkClearValue GetClearValue(const BeginRenderPassCommand::DepthStencilAttachment& depth_stencil_attachment);
     void HandleCmdEndRenderPass(CommandListState& state);
     void HandleCmdUseShaderProgram(CommandListState& state, const UseShaderProgramCommand& command);
     void HandleCmdUseRasterizerState(CommandListState& state, const UseRasterizerStateCommand& command);
@@ -88,25 +177,64 @@ class Queue final : public QueueBase {
     void HandleCmdBindVertexBuffer(CommandListState& state, const BindVertexBufferCommand& command);
     void HandleCmdBindIndexBuffer(CommandListState& state, const BindIndexBufferCommand& command);
     void HandleCmdBindResourceSet(CommandListState& state, const BindResourceSetCommand& command);
+    void HandleCmdPushConstants(CommandListState& state, const PushConstantsCommand& command);
     void HandleCmdDraw(CommandListState& state, const DrawCommand& command);
     void HandleCmdDrawIndexed(CommandListState& state, const DrawIndexedCommand& command);
+    void HandleCmdDrawIndirect(CommandListState& state, const DrawIndirectCommand& command);
+    void HandleCmdDrawIndexedIndirect(CommandListState& state, const DrawIndexedIndirectCommand& command);
+    void HandleCmdExecuteCommandBundle(CommandListState& state, const ExecuteCommandBundleCommand& command);
+    void HandleCmdBeginComputePass(CommandListState& state);
+    void HandleCmdEndComputePass(CommandListState& state);
+    void HandleCmdDispatch(CommandListState& state, const DispatchCommand& command);
+    void HandleCmdDispatchIndirect(CommandListState& state, const DispatchIndirectCommand& command);
+
+    bool BindGraphicsPipelineForCurrentState(CommandListState& state);
+    bool BindComputePipelineForCurrentState(CommandListState& state);
+    static void WaitForPendingComputeWrites(CommandListState& state);
+    static void RecordMemoryBarrier(
+      VkCommandBuffer vk_cmd_buffer,
+      VkPipelineStageFlags vk_src_stage_mask,
+      VkAccessFlags vk_src_access_mask,
+      VkPipelineStageFlags vk_dst_stage_mask,
+      VkAccessFlags vk_dst_access_mask
+    );
 
-    void BindGraphicsPipelineForCurrentState(CommandListState& state);
+    void RecordPendingUploads();
+    void RecordPendingBufferUploads(Buffer* buffer, PendingBufferUploads& pending_uploads);
+    void RecordPendingTextureUploads(Texture* texture, PendingTextureUploads& pending_uploads);
+    static bool TextureRegionsOverlap(const VkBufferImageCopy& a, const VkBufferImageCopy& b);
 
+    void ReclaimCompletedSubmissions();
     void DestroySwapChainAcquireSemaphore();
+    void MarkRecordedWork();
 
     Device* m_device;
     VkDevice m_vk_device;
     VkQueue m_vk_queue;
+    u32 m_queue_family_index;
     size_t m_current_cmd_buffer{};
     VkCommandPool m_vk_cmd_pool;
     VkCommandBuffer m_vk_cmd_buffer;
-    VkFence m_vk_cmd_buffer_fence;
-    std::vector<FencedCommandBuffer> m_fenced_cmd_buffers;
+    std::vector<SubmittedCommandBuffer> m_cmd_buffers;
+
+    VkSemaphore m_vk_timeline_semaphore;
+    std::atomic<u64> m_last_submission_index{};
+    std::atomic<u64> m_completed_submission_index{};
+    u64 m_reclaimed_submission_index{};
 
     std::shared_ptr<DeleterQueue> m_deleter_queue;
+    u32 m_deleter_timeline;
+    bool m_drains_deleter_queue;
+    bool m_have_recorded_work{}; // Whether the current command buffer may reference resources, since it was begun.
     std::shared_ptr<RenderPassCache> m_render_pass_cache;
-    GraphicsPipelineCache m_graphics_pipeline_cache;
+    std::shared_ptr<FramebufferCache> m_framebuffer_cache;
+    std::shared_ptr<GraphicsPipelineCache> m_graphics_pipeline_cache;
+    std::shared_ptr<ComputePipelineCache> m_compute_pipeline_cache;
+    bool m_use_dynamic_rendering; // Begin render passes with vkCmdBeginRendering() instead of render pass and framebuffer objects.
+    std::unique_ptr<StagingRing> m_staging_ring{};
+    std::unique_ptr<StagingRing> m_transient_ring{};
+    std::unordered_map<Buffer*, PendingBufferUploads> m_pending_buffer_uploads{};
+    std::unordered_map<Texture*, PendingTextureUploads> m_pending_texture_uploads{};
     VkSemaphore m_vk_swap_chain_acquire_semaphore{};
 };
 
@@ -26,6 +26,48 @@ void RenderPassQuery::SetDepthStencilAttachment(MGPUTextureFormat format, MGPULo
   m_have_depth_stencil_attachment = true;
 }
 
+RenderPassQuery RenderPassQuery::GetCompatibilityQuery() const {
+  RenderPassQuery compatibility_query = *this;
+
+  for(size_t i = 0; i < limits::max_color_attachments; i++) {
+    compatibility_query.m_color_attachment_load_ops[i] = MGPU_LOAD_OP_DONT_CARE;
+    compatibility_query.m_color_attachment_store_ops[i] = MGPU_STORE_OP_DONT_CARE;
+  }
+
+  compatibility_query.m_depth_load_op = MGPU_LOAD_OP_DONT_CARE;
+  compatibility_query.m_depth_store_op = MGPU_STORE_OP_DONT_CARE;
+  compatibility_query.m_stencil_load_op = MGPU_LOAD_OP_DONT_CARE;
+  compatibility_query.m_stencil_store_op = MGPU_STORE_OP_DONT_CARE;
+  return compatibility_query;
+}
+
+RenderTargetFormats RenderPassQuery::GetRenderTargetFormats() const {
+  RenderTargetFormats render_target_formats{};
+
+  u32 color_attachment_set = m_color_attachment_set;
+
+  while(color_attachment_set != 0u) {
+    const size_t i = __builtin_ctz(color_attachment_set);
+    render_target_formats.m_vk_color_attachment_formats[i] = MGPUTextureFormatToVkFormat(m_color_attachment_formats[i]);
+    color_attachment_set ^= 1 << i;
+  }
+  render_target_formats.m_color_attachment_set = m_color_attachment_set;
+
+  if(m_have_depth_stencil_attachment) {
+    const VkFormat vk_depth_stencil_format = MGPUTextureFormatToVkFormat(m_depth_stencil_format);
+    const MGPUTextureAspect texture_aspect = MGPUTextureFormatToMGPUTextureAspect(m_depth_stencil_format);
+
+    if(texture_aspect & MGPU_TEXTURE_ASPECT_DEPTH) {
+      render_target_formats.m_vk_depth_format = vk_depth_stencil_format;
+    }
+    if(texture_aspect & MGPU_TEXTURE_ASPECT_STENCIL) {
+      render_target_formats.m_vk_stencil_format = vk_depth_stencil_format;
+    }
+  }
+
+  return render_target_formats;
+}
+
 [[nodiscard]] bool RenderPassQuery::operator==(const RenderPassQuery& other_query) const {
   if(m_color_attachment_set != other_query.m_color_attachment_set) {
     return false;
@@ -102,19 +144,23 @@ RenderPassCache::RenderPassCache(VkDevice vk_device, std::shared_ptr<DeleterQueu
 }
 
 RenderPassCache::~RenderPassCache() {
-  for(const auto& [query_key, vk_render_pass] : m_query_to_vk_render_pass) {
+  m_query_to_vk_render_pass.ForEach([&](const RenderPassQuery&, VkRenderPass vk_render_pass) {
     // Defer deletion of underlying Vulkan resources until the currently recorded frame has been fully processed on the GPU.
     VkDevice vk_device = m_vk_device;
     m_deleter_queue->Schedule([vk_device, vk_render_pass]() {
       vkDestroyRenderPass(vk_device, vk_render_pass, nullptr);
     });
-  }
+  });
 }
 
 Result<VkRenderPass> RenderPassCache::GetRenderPass(const RenderPassQuery& query) {
-  VkRenderPass vk_render_pass = m_query_to_vk_render_pass[query];
-  if(vk_render_pass != nullptr) {
-    return vk_render_pass;
+  const size_t query_hash = RenderPassQuery::Hasher{}(query);
+
+  // The cache is shared by all queues, which may record command lists on different threads.
+  std::lock_guard lock_guard{m_mutex};
+
+  if(const VkRenderPass* vk_render_pass = m_query_to_vk_render_pass.Find(query, query_hash); vk_render_pass != nullptr) {
+    return *vk_render_pass;
   }
 
   atom::Vector_N<VkAttachmentDescription, limits::max_total_attachments> vk_attachment_descriptions{};
@@ -200,9 +246,14 @@ Result<VkRenderPass> RenderPassCache::GetRenderPass(const RenderPassQuery& query
     .pDependencies = nullptr
   };
 
+  VkRenderPass vk_render_pass{};
   MGPU_VK_FORWARD_ERROR(vkCreateRenderPass(m_vk_device, &vk_render_pass_create_info, nullptr, &vk_render_pass));
-  m_query_to_vk_render_pass[query] = vk_render_pass;
+  *m_query_to_vk_render_pass.TryEmplace(query, query_hash).first = vk_render_pass;
   return vk_render_pass;
 }
 
+Result<VkRenderPass> RenderPassCache::GetCompatibleRenderPass(const RenderPassQuery& query) {
+  return GetRenderPass(query.GetCompatibilityQuery());
+}
+
 } // namespace mgpu::vulkan
@@ -6,15 +6,33 @@
 #include <atom/hash.hpp>
 #include <atom/integer.hpp>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
 #include <vulkan/vulkan.h>
 
+#include "common/flat_hash_map.hpp"
 #include "common/limits.hpp"
 #include "common/result.hpp"
 #include "deleter_queue.hpp"
 
 namespace mgpu::vulkan {
 
+/**
+ * The attachment formats of a render pass, which is all that pipelines depend on when rendering without render pass objects.
+ * Color attachments which are not in use have the format VK_FORMAT_UNDEFINED.
+ */
+struct RenderTargetFormats {
+  [[nodiscard]] u32 ColorAttachmentCount() const {
+    return m_color_attachment_set == 0u ? 0u : 32u - __builtin_clz(m_color_attachment_set);
+  }
+
+  [[nodiscard]] bool operator==(const RenderTargetFormats& other_formats) const = default;
+
+  u32 m_color_attachment_set{};
+  VkFormat m_vk_color_attachment_formats[limits::max_color_attachments]{};
+  VkFormat m_vk_depth_format{VK_FORMAT_UNDEFINED};
+  VkFormat m_vk_stencil_format{VK_FORMAT_UNDEFINED};
+};
+
 struct RenderPassQuery {
   struct Hasher {
     size_t operator()(const RenderPassQuery& query) const;
@@ -30,6 +48,15 @@ struct RenderPassQuery {
     MGPUStoreOp stencil_store_op
   );
 
+  /**
+   * Returns the query for a render pass that is compatible with this render pass, but independent of the load and store operations.
+   * Vulkan only requires render passes to be compatible (same formats and sample counts) for creating pipelines and framebuffers,
+   * so using this query for these avoids creating duplicate objects for each variant of load and store operations.
+   */
+  [[nodiscard]] RenderPassQuery GetCompatibilityQuery() const;
+
+  [[nodiscard]] RenderTargetFormats GetRenderTargetFormats() const;
+
   [[nodiscard]] bool operator==(const RenderPassQuery& other_query) const;
 
   u32 m_color_attachment_set{};
@@ -53,11 +80,13 @@ class RenderPassCache {
    ~RenderPassCache();
 
     Result<VkRenderPass> GetRenderPass(const RenderPassQuery& query);
+    Result<VkRenderPass> GetCompatibleRenderPass(const RenderPassQuery& query);
 
   private:
     VkDevice m_vk_device;
     std::shared_ptr<DeleterQueue> m_deleter_queue;
-    std::unordered_map<RenderPassQuery, VkRenderPass, RenderPassQuery::Hasher> m_query_to_vk_render_pass{};
+    std::mutex m_mutex{};
+    FlatHashMap<RenderPassQuery, VkRenderPass> m_query_to_vk_render_pass{};
 };
 
 } // namespace mgpu::vulkan
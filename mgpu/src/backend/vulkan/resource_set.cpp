@@ -11,76 +11,72 @@
 
 namespace mgpu::vulkan {
 
-ResourceSet::ResourceSet(Device* device, VkDescriptorPool vk_descriptor_pool, VkDescriptorSet vk_descriptor_set)
-    : m_device{device}
-    , m_vk_descriptor_pool{vk_descriptor_pool}
-    , m_vk_descriptor_set{vk_descriptor_set} {
+ResourceSet::ResourceSet(
+  Device* device,
+  DescriptorAllocator::LayoutKey descriptor_allocator_key,
+  const DescriptorAllocator::Allocation& allocation,
+  bool transient,
+  const MGPUResourceSetCreateInfo& create_info
+)   : ResourceSetBase{create_info}
+    , m_device{device}
+    , m_descriptor_allocator_key{descriptor_allocator_key}
+    , m_allocation{allocation}
+    , m_transient{transient} {
+  for(size_t i = 0u; i < create_info.binding_count; i++) {
+    const MGPUResourceSetBinding& mgpu_binding = create_info.bindings[i];
+    if(mgpu_binding.type == MGPU_RESOURCE_BINDING_TYPE_STORAGE_TEXTURE) {
+      m_storage_textures.push_back((Texture*)((TextureView*)mgpu_binding.texture.texture_view)->GetTexture());
+    }
+  }
 }
 
 ResourceSet::~ResourceSet() {
+  // Transient descriptor sets are released all at once, when the queue resets their descriptor pools.
+  if(m_transient) {
+    return;
+  }
+
   // TODO(fleroviux): make this a little bit less verbose.
   Device* device = m_device;
-  VkDescriptorPool vk_descriptor_pool = m_vk_descriptor_pool;
-  VkDescriptorSet vk_descriptor_set = m_vk_descriptor_set;
-  device->GetDeleterQueue().Schedule([device, vk_descriptor_pool, vk_descriptor_set]() {
-    vkFreeDescriptorSets(device->Handle(), vk_descriptor_pool, 1u, &vk_descriptor_set);
+  DescriptorAllocator::LayoutKey descriptor_allocator_key = m_descriptor_allocator_key;
+  DescriptorAllocator::Allocation allocation = m_allocation;
+  device->GetDeleterQueue().Schedule([device, descriptor_allocator_key, allocation]() {
+    device->GetDescriptorAllocator().Free(descriptor_allocator_key, allocation);
   });
 }
 
 Result<ResourceSetBase*> ResourceSet::Create(Device* device, const MGPUResourceSetCreateInfo& create_info) {
-  const VkDescriptorSetLayout vk_descriptor_set_layout = ((ResourceSetLayout*)create_info.layout)->Handle();
-
-  // Well. It works, doesn't it?
-  static VkDescriptorPool vk_descriptor_pool{};
-  if(vk_descriptor_pool == VK_NULL_HANDLE) {
-    const VkDescriptorPoolSize vk_descriptor_pool_sizes[] {
-      {
-        .type = VK_DESCRIPTOR_TYPE_SAMPLER,
-        .descriptorCount = 65536u
-      },
-      {
-        .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-        .descriptorCount = 65536u
-      },
-      {
-        .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-        .descriptorCount = 65536u
-      },
-      {
-        .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-        .descriptorCount = 65536u
-      },
-      {
-        .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-        .descriptorCount = 65536u
-      },
-      {
-        .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-        .descriptorCount = 65536u
-      }
-    };
-    const VkDescriptorPoolCreateInfo vk_descriptor_pool_create_info{
-      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-      .pNext = nullptr,
-      .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT | VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
-      .maxSets = 16384u,
-      .poolSizeCount = sizeof(vk_descriptor_pool_sizes) / sizeof(VkDescriptorPoolSize),
-      .pPoolSizes = vk_descriptor_pool_sizes
-    };
-    MGPU_VK_FORWARD_ERROR(vkCreateDescriptorPool(device->Handle(), &vk_descriptor_pool_create_info, nullptr, &vk_descriptor_pool));
-  }
+  const auto layout = (ResourceSetLayout*)create_info.layout;
+  const VkDescriptorSetLayout vk_descriptor_set_layout = layout->Handle();
+
+  const DescriptorAllocator::LayoutKey descriptor_allocator_key = layout->GetDescriptorAllocatorKey();
 
-  const VkDescriptorSetAllocateInfo vk_allocate_info{
-    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-    .pNext = nullptr,
-    .descriptorPool = vk_descriptor_pool,
-    .descriptorSetCount = 1u,
-    .pSetLayouts = &vk_descriptor_set_layout
-  };
+  Result<DescriptorAllocator::Allocation> allocation_result = device->GetDescriptorAllocator().Allocate(
+    descriptor_allocator_key, vk_descriptor_set_layout, layout->GetDescriptorCounts());
+  MGPU_FORWARD_ERROR(allocation_result.Code());
 
-  VkDescriptorSet vk_descriptor_set{};
-  MGPU_VK_FORWARD_ERROR(vkAllocateDescriptorSets(device->Handle(), &vk_allocate_info, &vk_descriptor_set));
+  const DescriptorAllocator::Allocation allocation = allocation_result.Unwrap();
+  WriteDescriptors(device, allocation.vk_descriptor_set, create_info);
+  return new ResourceSet{device, descriptor_allocator_key, allocation, false, create_info};
+}
+
+Result<std::unique_ptr<ResourceSet>> ResourceSet::CreateTransient(
+  Device* device,
+  TransientDescriptorAllocator& transient_descriptor_allocator,
+  const MGPUResourceSetCreateInfo& create_info
+) {
+  const auto layout = (ResourceSetLayout*)create_info.layout;
+  const VkDescriptorSetLayout vk_descriptor_set_layout = layout->Handle();
 
+  Result<VkDescriptorSet> vk_descriptor_set_result = transient_descriptor_allocator.Allocate(vk_descriptor_set_layout, layout->GetDescriptorCounts());
+  MGPU_FORWARD_ERROR(vk_descriptor_set_result.Code());
+
+  const VkDescriptorSet vk_descriptor_set = vk_descriptor_set_result.Unwrap();
+  WriteDescriptors(device, vk_descriptor_set, create_info);
+  return std::unique_ptr<ResourceSet>{new ResourceSet{device, layout->GetDescriptorAllocatorKey(), {VK_NULL_HANDLE, vk_descriptor_set}, true, create_info}};
+}
+
+void ResourceSet::WriteDescriptors(Device* device, VkDescriptorSet vk_descriptor_set, const MGPUResourceSetCreateInfo& create_info) {
   std::vector<VkWriteDescriptorSet> vk_descriptor_writes{};
   vk_descriptor_writes.resize(create_info.binding_count);
 
@@ -161,6 +157,25 @@ Result<ResourceSetBase*> ResourceSet::Create(Device* device, const MGPUResourceS
         vk_descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         break;
       }
+      case MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER_DYNAMIC: {
+        // The dynamic offset passed when binding the resource set is added to the offset given here.
+        vk_buffer_info = {
+          .buffer = ((Buffer*)mgpu_binding.buffer.buffer)->Handle(),
+          .offset = mgpu_binding.buffer.offset,
+          .range = mgpu_binding.buffer.size
+        };
+        vk_descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        break;
+      }
+      case MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER_DYNAMIC: {
+        vk_buffer_info = {
+          .buffer = ((Buffer*)mgpu_binding.buffer.buffer)->Handle(),
+          .offset = mgpu_binding.buffer.offset,
+          .range = mgpu_binding.buffer.size
+        };
+        vk_descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        break;
+      }
       default: {
         ATOM_PANIC("unknown resource binding type: {}", (int)mgpu_binding.type);
       }
@@ -168,7 +183,6 @@ Result<ResourceSetBase*> ResourceSet::Create(Device* device, const MGPUResourceS
   }
 
   vkUpdateDescriptorSets(device->Handle(), (u32)vk_descriptor_writes.size(), vk_descriptor_writes.data(), 0u, nullptr);
-  return new ResourceSet{device, vk_descriptor_pool, vk_descriptor_set};
 }
 
 } // namespace mgpu::vulkan
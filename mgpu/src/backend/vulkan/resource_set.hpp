@@ -2,14 +2,19 @@
 #pragma once
 
 #include <mgpu/mgpu.h>
+#include <memory>
+#include <span>
+#include <vector>
 #include <vulkan/vulkan.h>
 
 #include "backend/resource_set.hpp"
 #include "common/result.hpp"
+#include "descriptor_allocator.hpp"
 
 namespace mgpu::vulkan {
 
 class Device;
+class Texture;
 
 class ResourceSet : public ResourceSetBase {
   public:
@@ -17,14 +22,34 @@ class ResourceSet : public ResourceSetBase {
 
     static Result<ResourceSetBase*> Create(Device* device, const MGPUResourceSetCreateInfo& create_info);
 
-    [[nodiscard]] VkDescriptorSet Handle() { return m_vk_descriptor_set; }
+    /// Creates a resource set whose descriptor set is released together with all other descriptor sets of the allocator, when it is reset.
+    static Result<std::unique_ptr<ResourceSet>> CreateTransient(
+      Device* device,
+      TransientDescriptorAllocator& transient_descriptor_allocator,
+      const MGPUResourceSetCreateInfo& create_info
+    );
+
+    [[nodiscard]] VkDescriptorSet Handle() { return m_allocation.vk_descriptor_set; }
+
+    /// The textures bound as storage textures, which must be in VK_IMAGE_LAYOUT_GENERAL while the resource set is used.
+    [[nodiscard]] std::span<Texture* const> GetStorageTextures() const { return m_storage_textures; }
 
   private:
-    ResourceSet(Device* device, VkDescriptorPool vk_descriptor_pool, VkDescriptorSet vk_descriptor_set);
+    ResourceSet(
+      Device* device,
+      DescriptorAllocator::LayoutKey descriptor_allocator_key,
+      const DescriptorAllocator::Allocation& allocation,
+      bool transient,
+      const MGPUResourceSetCreateInfo& create_info
+    );
+
+    static void WriteDescriptors(Device* device, VkDescriptorSet vk_descriptor_set, const MGPUResourceSetCreateInfo& create_info);
 
     Device* m_device;
-    VkDescriptorPool m_vk_descriptor_pool;
-    VkDescriptorSet m_vk_descriptor_set;
+    DescriptorAllocator::LayoutKey m_descriptor_allocator_key; // Used for recycling the descriptor set.
+    DescriptorAllocator::Allocation m_allocation;
+    bool m_transient;
+    std::vector<Texture*> m_storage_textures{};
 };
 
 } // namespace mgpu::vulkan
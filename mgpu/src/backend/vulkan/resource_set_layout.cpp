@@ -8,16 +8,26 @@
 
 namespace mgpu::vulkan {
 
-ResourceSetLayout::ResourceSetLayout(Device *device, VkDescriptorSetLayout vk_descriptor_set_layout)
-    : m_device{device}
-    , m_vk_descriptor_set_layout{vk_descriptor_set_layout} {
+ResourceSetLayout::ResourceSetLayout(
+  Device *device,
+  VkDescriptorSetLayout vk_descriptor_set_layout,
+  const DescriptorCounts& descriptor_counts,
+  DescriptorAllocator::LayoutKey descriptor_allocator_key,
+  const MGPUResourceSetLayoutCreateInfo& create_info
+)   : ResourceSetLayoutBase{create_info}
+    , m_device{device}
+    , m_vk_descriptor_set_layout{vk_descriptor_set_layout}
+    , m_descriptor_counts{descriptor_counts}
+    , m_descriptor_allocator_key{descriptor_allocator_key} {
 }
 
 ResourceSetLayout::~ResourceSetLayout() {
   // TODO(fleroviux): make this a little bit less verbose.
   Device* device = m_device;
   VkDescriptorSetLayout vk_descriptor_set_layout = m_vk_descriptor_set_layout;
-  device->GetDeleterQueue().Schedule([device, vk_descriptor_set_layout]() {
+  DescriptorAllocator::LayoutKey descriptor_allocator_key = m_descriptor_allocator_key;
+  device->GetDeleterQueue().Schedule([device, vk_descriptor_set_layout, descriptor_allocator_key]() {
+    device->GetDescriptorAllocator().ReleaseLayout(descriptor_allocator_key);
     vkDestroyDescriptorSetLayout(device->Handle(), vk_descriptor_set_layout, nullptr);
   });
 }
@@ -26,6 +36,8 @@ Result<ResourceSetLayoutBase*> ResourceSetLayout::Create(Device* device, const M
   std::vector<VkDescriptorSetLayoutBinding> vk_bindings{};
   vk_bindings.resize(create_info.binding_count);
 
+  DescriptorCounts descriptor_counts{};
+
   for(size_t i = 0u; i < create_info.binding_count; i++) {
     const MGPUResourceSetLayoutBinding& mgpu_binding = create_info.bindings[i];
 
@@ -36,6 +48,7 @@ Result<ResourceSetLayoutBase*> ResourceSetLayout::Create(Device* device, const M
       .stageFlags = MGPUShaderStagesToVkShaderStageFlags(mgpu_binding.visibility),
       .pImmutableSamplers = nullptr
     };
+    descriptor_counts[vk_bindings[i].descriptorType] += vk_bindings[i].descriptorCount;
   }
 
   const VkDescriptorSetLayoutCreateInfo vk_create_info{
@@ -48,7 +61,8 @@ Result<ResourceSetLayoutBase*> ResourceSetLayout::Create(Device* device, const M
 
   VkDescriptorSetLayout vk_descriptor_set_layout{};
   MGPU_VK_FORWARD_ERROR(vkCreateDescriptorSetLayout(device->Handle(), &vk_create_info, nullptr, &vk_descriptor_set_layout));
-  return new ResourceSetLayout{device, vk_descriptor_set_layout};
+  const DescriptorAllocator::LayoutKey descriptor_allocator_key = device->GetDescriptorAllocator().RegisterLayout();
+  return new ResourceSetLayout{device, vk_descriptor_set_layout, descriptor_counts, descriptor_allocator_key, create_info};
 }
 
 } // namespace mgpu::vulkan
@@ -6,6 +6,7 @@
 
 #include "backend/resource_set_layout.hpp"
 #include "common/result.hpp"
+#include "descriptor_allocator.hpp"
 
 namespace mgpu::vulkan {
 
@@ -18,12 +19,22 @@ class ResourceSetLayout : public ResourceSetLayoutBase {
     static Result<ResourceSetLayoutBase*> Create(Device* device, const MGPUResourceSetLayoutCreateInfo& create_info);
 
     [[nodiscard]] VkDescriptorSetLayout Handle() { return m_vk_descriptor_set_layout; }
+    [[nodiscard]] const DescriptorCounts& GetDescriptorCounts() const { return m_descriptor_counts; }
+    [[nodiscard]] DescriptorAllocator::LayoutKey GetDescriptorAllocatorKey() const { return m_descriptor_allocator_key; }
 
   private:
-    ResourceSetLayout(Device* device, VkDescriptorSetLayout vk_descriptor_set_layout);
+    ResourceSetLayout(
+      Device* device,
+      VkDescriptorSetLayout vk_descriptor_set_layout,
+      const DescriptorCounts& descriptor_counts,
+      DescriptorAllocator::LayoutKey descriptor_allocator_key,
+      const MGPUResourceSetLayoutCreateInfo& create_info
+    );
 
     Device* m_device;
     VkDescriptorSetLayout m_vk_descriptor_set_layout;
+    DescriptorCounts m_descriptor_counts;
+    DescriptorAllocator::LayoutKey m_descriptor_allocator_key;
 };
 
 } // namespace mgpu::vulkan
@@ -0,0 +1,116 @@
+
+#include <algorithm>
+#include <bit>
+
+#include "buffer.hpp"
+#include "staging_ring.hpp"
+
+namespace mgpu::vulkan {
+
+StagingRing::StagingRing(Device* device, MGPUBufferUsage usage)
+    : m_device{device}
+    , m_usage{usage} {
+}
+
+StagingRing::~StagingRing() = default;
+
+Result<StagingRing::Allocation> StagingRing::Allocate(u64 size, u64 alignment) {
+  alignment = std::max(alignment, k_min_alignment);
+
+  const u64 aligned_size = (size + k_min_alignment - 1u) & ~(k_min_alignment - 1u);
+
+  // The capacity is a power of two, so offset zero satisfies any alignment which does not exceed it.
+  if(m_buffer == nullptr || aligned_size > m_capacity || alignment > m_capacity) {
+    MGPU_FORWARD_ERROR(Grow(std::max(aligned_size, alignment)));
+  }
+
+  u64 head = m_head;
+  u64 offset = (head - m_base) % m_capacity;
+  const u64 aligned_offset = (offset + alignment - 1u) & ~(alignment - 1u);
+
+  // Allocations must be contiguous, so skip over the end of the buffer if the allocation doesn't fit there.
+  if(aligned_offset + aligned_size > m_capacity) {
+    head += m_capacity - offset;
+    offset = 0u;
+  } else {
+    head += aligned_offset - offset;
+    offset = aligned_offset;
+  }
+
+  if(head + aligned_size - m_tail > m_capacity) {
+    MGPU_FORWARD_ERROR(Grow(aligned_size));
+    head = m_head;
+    offset = 0u;
+  }
+
+  m_head = head + aligned_size;
+  return Allocation{m_buffer.get(), offset, m_address + offset};
+}
+
+void StagingRing::Release(u64 position) {
+  m_tail = std::max(m_tail, position);
+
+  std::erase_if(m_retired_buffers, [&](const RetiredBuffer& retired_buffer) {
+    return retired_buffer.position <= position;
+  });
+}
+
+MGPUResult StagingRing::FlushHostWrites() {
+  // A buffer which has been replaced since the last flush may have been written to anywhere.
+  for(const RetiredBuffer& retired_buffer : m_retired_buffers) {
+    if(retired_buffer.position > m_flushed_head) {
+      MGPU_FORWARD_ERROR(retired_buffer.buffer->FlushRange(0u, retired_buffer.buffer->Size()));
+    }
+  }
+
+  const u64 begin = std::max(m_flushed_head, m_base);
+  const u64 size = m_head - begin;
+  m_flushed_head = m_head;
+
+  if(size == 0u) {
+    return MGPU_SUCCESS;
+  }
+
+  if(size >= m_capacity) {
+    return m_buffer->FlushRange(0u, m_capacity);
+  }
+
+  // The range may wrap around the end of the buffer.
+  const u64 offset = (begin - m_base) % m_capacity;
+  if(offset + size > m_capacity) {
+    MGPU_FORWARD_ERROR(m_buffer->FlushRange(offset, m_capacity - offset));
+    return m_buffer->FlushRange(0u, offset + size - m_capacity);
+  }
+  return m_buffer->FlushRange(offset, size);
+}
+
+MGPUResult StagingRing::Grow(u64 min_capacity) {
+  const u64 capacity = std::max({k_initial_capacity, m_capacity * 2u, std::bit_ceil(min_capacity)});
+
+  Result<BufferBase*> buffer_result = Buffer::Create(m_device, {
+    .size = capacity,
+    .usage = m_usage,
+    .flags = MGPU_BUFFER_FLAGS_HOST_VISIBLE
+  });
+  MGPU_FORWARD_ERROR(buffer_result.Code());
+
+  std::unique_ptr<Buffer> buffer{(Buffer*)buffer_result.Unwrap()};
+
+  Result<void*> address_result = buffer->Map();
+  MGPU_FORWARD_ERROR(address_result.Code());
+
+  // The old buffer may still be in use, so it is only destroyed once all memory allocated from it has been released.
+  if(m_buffer != nullptr) {
+    m_retired_buffers.push_back({std::move(m_buffer), m_head});
+  }
+  m_buffer = std::move(buffer);
+  m_address = (u8*)address_result.Unwrap();
+  m_capacity = capacity;
+
+  // Start over with an empty ring. Any older position passed to Release() lies behind the new tail and thus is ignored.
+  m_base = m_head;
+  m_tail = m_head;
+  return MGPU_SUCCESS;
+}
+
+}  // namespace mgpu::vulkan
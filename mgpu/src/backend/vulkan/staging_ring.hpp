@@ -0,0 +1,76 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
+#include <atom/non_moveable.hpp>
+#include <memory>
+#include <vector>
+
+#include "common/result.hpp"
+
+namespace mgpu::vulkan {
+
+class Buffer;
+class Device;
+
+/**
+ * A persistently mapped, host-visible buffer which uploads are staged in and which transient allocations are made from.
+ * Memory is handed out in FIFO order and is given back once the command buffer which consumed it has completed.
+ * Positions are tracked as monotonically increasing virtual offsets, so that a full ring can be told apart from an empty one.
+ * If the ring runs out of space it is replaced by a larger one, instead of stalling on the GPU.
+ */
+class StagingRing : atom::NonCopyable, atom::NonMoveable {
+  public:
+    struct Allocation {
+      Buffer* buffer;
+      u64 offset;
+      u8* address;
+    };
+
+    StagingRing(Device* device, MGPUBufferUsage usage);
+   ~StagingRing();
+
+    [[nodiscard]] MGPUBufferUsage Usage() const { return m_usage; }
+
+    /// The alignment must be a power of two. Allocations are always aligned to at least 16 bytes.
+    Result<Allocation> Allocate(u64 size, u64 alignment = k_min_alignment);
+
+    /// Returns the position up to which memory will be available again, once all work recorded so far has completed.
+    [[nodiscard]] u64 GetHead() const { return m_head; }
+
+    /// Gives back all memory allocated before the given position (as returned by GetHead()).
+    void Release(u64 position);
+
+    /// Makes all host writes to memory allocated since the last call visible to the device, in case the memory is not host-coherent.
+    MGPUResult FlushHostWrites();
+
+  private:
+    struct RetiredBuffer {
+      std::unique_ptr<Buffer> buffer;
+      u64 position; // The head at the time the buffer was replaced.
+    };
+
+    static constexpr u64 k_initial_capacity = 4u * 1024u * 1024u;
+
+    // Satisfies the alignment requirements of buffer copies and of buffer to image copies for all texture formats.
+    static constexpr u64 k_min_alignment = 16u;
+
+    MGPUResult Grow(u64 min_capacity);
+
+    Device* m_device;
+    MGPUBufferUsage m_usage;
+    std::unique_ptr<Buffer> m_buffer{};
+    u8* m_address{};
+    u64 m_capacity{};
+    u64 m_base{};
+    u64 m_head{};
+    u64 m_tail{};
+    u64 m_flushed_head{};
+
+    // Replaced buffers may still be referenced by commands which have not been recorded yet, so keep them until they are released.
+    std::vector<RetiredBuffer> m_retired_buffers{};
+};
+
+}  // namespace mgpu::vulkan
@@ -28,6 +28,8 @@ Texture::Texture(Device* device, VkImage vk_image, VmaAllocation vma_allocation,
 }
 
 Texture::~Texture() {
+  m_device->DiscardPendingUploads(this);
+
   if(m_vma_allocation != nullptr) { // When m_vma_allocation is null the VkImage is not owned by this texture.
     // Defer deletion of underlying Vulkan resources until the currently recorded frame has been fully processed on the GPU.
     // TODO(fleroviux): make this a little bit less verbose.
@@ -13,6 +13,8 @@ TextureView::TextureView(Device* device, Texture* texture, VkImageView vk_image_
 }
 
 TextureView::~TextureView() {
+  m_device->GetFramebufferCache().Invalidate(m_vk_image_view);
+
   // Defer deletion of underlying Vulkan resources until the currently recorded frame has been fully processed on the GPU.
   // TODO(fleroviux): make this a little bit less verbose.
   Device* device = m_device;
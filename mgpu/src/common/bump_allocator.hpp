@@ -2,6 +2,7 @@
 #pragma once
 
 #include <atom/integer.hpp>
+#include <atom/non_copyable.hpp>
 #include <atom/panic.hpp>
 #include <cstdlib>
 
@@ -16,7 +17,7 @@
 
 namespace mgpu {
 
-class BumpAllocator {
+class BumpAllocator : atom::NonCopyable {
   public:
     explicit BumpAllocator(size_t capacity) {
 #if defined(WIN32) && !defined(MGPU_BUMP_ALLOC_USE_MALLOC)
@@ -34,7 +35,20 @@ class BumpAllocator {
       Reset();
     }
 
+    BumpAllocator(BumpAllocator&& other_allocator) noexcept
+        : m_base_address{other_allocator.m_base_address}
+        , m_current_address{other_allocator.m_current_address}
+        , m_maximum_address{other_allocator.m_maximum_address} {
+      other_allocator.m_base_address = nullptr;
+      other_allocator.m_current_address = nullptr;
+      other_allocator.m_maximum_address = nullptr;
+    }
+
    ~BumpAllocator() {
+      if(m_base_address == nullptr) {
+        return;
+      }
+
       const size_t capacity = m_maximum_address - m_base_address;
 
 #if defined(WIN32) && !defined(MGPU_BUMP_ALLOC_USE_MALLOC)
@@ -47,14 +61,17 @@ class BumpAllocator {
 #endif
     }
 
+    [[nodiscard]] const u8* GetBaseAddress() const { return m_base_address; }
+    [[nodiscard]] const u8* GetCurrentAddress() const { return m_current_address; }
+
     void Reset() {
       m_current_address = m_base_address;
     }
 
     void* Allocate(size_t number_of_bytes) {
       u8* address = m_current_address;
-      m_current_address += number_of_bytes;
-      if(m_current_address <= m_maximum_address) {
+      if(number_of_bytes <= (size_t)(m_maximum_address - address)) {
+        m_current_address += number_of_bytes;
         return address;
       }
       return nullptr;
@@ -0,0 +1,172 @@
+
+#pragma once
+
+#include <atom/integer.hpp>
+#include <utility>
+#include <vector>
+
+namespace mgpu {
+
+/**
+ * Open-addressing hash map with linear probing, which stores all entries in a single contiguous array.
+ * Lookups take the hash of the key as an argument, so that callers which look up the same key repeatedly
+ * (or in more than one map) only need to compute it once.
+ *
+ * A separate array of control bytes holds seven bits of the hash of each occupied slot,
+ * so that most mismatching slots are skipped without comparing keys.
+ * Erased entries are removed by shifting the following entries of the probe sequence back, so no tombstones are needed.
+ *
+ * Pointers to values are invalidated by insertions and removals.
+ */
+template<typename TKey, typename TValue>
+class FlatHashMap {
+  public:
+    [[nodiscard]] size_t Size() const { return m_size; }
+
+    TValue* Find(const TKey& key, size_t hash) {
+      const size_t i = FindSlot(key, Mix(hash));
+      return i != k_not_found ? &m_slots[i].value : nullptr;
+    }
+
+    const TValue* Find(const TKey& key, size_t hash) const {
+      const size_t i = FindSlot(key, Mix(hash));
+      return i != k_not_found ? &m_slots[i].value : nullptr;
+    }
+
+    /// Returns the value of the key and whether it has been inserted. Inserted values are default-constructed.
+    std::pair<TValue*, bool> TryEmplace(const TKey& key, size_t hash) {
+      const u64 mixed_hash = Mix(hash);
+
+      if(const size_t i = FindSlot(key, mixed_hash); i != k_not_found) {
+        return {&m_slots[i].value, false};
+      }
+
+      if((m_size + 1u) * 4u > m_slots.size() * 3u) {
+        Grow();
+      }
+
+      const size_t i = FindEmptySlot(mixed_hash);
+      m_controls[i] = GetControlByte(mixed_hash);
+      m_slots[i].mixed_hash = mixed_hash;
+      m_slots[i].key = key;
+      m_size++;
+      return {&m_slots[i].value, true};
+    }
+
+    bool Erase(const TKey& key, size_t hash) {
+      size_t i = FindSlot(key, Mix(hash));
+      if(i == k_not_found) {
+        return false;
+      }
+
+      // Move every following entry of the cluster back into the hole, unless it would end up before its ideal slot.
+      for(size_t j = (i + 1u) & m_mask; m_controls[j] != k_empty; j = (j + 1u) & m_mask) {
+        const size_t ideal_slot = m_slots[j].mixed_hash & m_mask;
+        const bool can_move = i <= j ? (ideal_slot <= i || ideal_slot > j) : (ideal_slot <= i && ideal_slot > j);
+        if(can_move) {
+          m_controls[i] = m_controls[j];
+          m_slots[i] = std::move(m_slots[j]);
+          i = j;
+        }
+      }
+
+      m_controls[i] = k_empty;
+      m_slots[i] = {};
+      m_size--;
+      return true;
+    }
+
+    void Clear() {
+      m_controls.clear();
+      m_slots.clear();
+      m_mask = 0u;
+      m_size = 0u;
+    }
+
+    template<typename TFunctor>
+    void ForEach(TFunctor&& functor) const {
+      for(size_t i = 0; i < m_slots.size(); i++) {
+        if(m_controls[i] != k_empty) {
+          functor(m_slots[i].key, m_slots[i].value);
+        }
+      }
+    }
+
+  private:
+    struct Slot {
+      u64 mixed_hash{};
+      TKey key{};
+      TValue value{};
+    };
+
+    static constexpr u8 k_empty = 0u;
+    static constexpr size_t k_initial_capacity = 16u;
+    static constexpr size_t k_not_found = ~(size_t)0u;
+
+    static u64 Mix(size_t hash) {
+      // Linear probing is sensitive to clustering, so scramble the hash first (finalizer of MurmurHash3).
+      u64 mixed_hash = (u64)hash;
+      mixed_hash ^= mixed_hash >> 33;
+      mixed_hash *= 0xFF51AFD7ED558CCDull;
+      mixed_hash ^= mixed_hash >> 33;
+      mixed_hash *= 0xC4CEB9FE1A85EC53ull;
+      mixed_hash ^= mixed_hash >> 33;
+      return mixed_hash;
+    }
+
+    static u8 GetControlByte(u64 mixed_hash) {
+      // Use the upper bits of the hash, because the lower bits already select the slot.
+      return 0x80u | (u8)(mixed_hash >> 57);
+    }
+
+    size_t FindSlot(const TKey& key, u64 mixed_hash) const {
+      if(m_size == 0u) {
+        return k_not_found;
+      }
+
+      const u8 control = GetControlByte(mixed_hash);
+
+      for(size_t i = mixed_hash & m_mask;; i = (i + 1u) & m_mask) {
+        if(m_controls[i] == control && m_slots[i].key == key) {
+          return i;
+        }
+        if(m_controls[i] == k_empty) {
+          return k_not_found;
+        }
+      }
+    }
+
+    size_t FindEmptySlot(u64 mixed_hash) const {
+      size_t i = mixed_hash & m_mask;
+      while(m_controls[i] != k_empty) {
+        i = (i + 1u) & m_mask;
+      }
+      return i;
+    }
+
+    void Grow() {
+      std::vector<u8> old_controls = std::move(m_controls);
+      std::vector<Slot> old_slots = std::move(m_slots);
+
+      const size_t capacity = old_slots.empty() ? k_initial_capacity : old_slots.size() * 2u;
+      m_controls.assign(capacity, k_empty);
+      m_slots.clear();
+      m_slots.resize(capacity);
+      m_mask = capacity - 1u;
+
+      for(size_t i = 0; i < old_slots.size(); i++) {
+        if(old_controls[i] != k_empty) {
+          const size_t j = FindEmptySlot(old_slots[i].mixed_hash);
+          m_controls[j] = old_controls[i];
+          m_slots[j] = std::move(old_slots[i]);
+        }
+      }
+    }
+
+    std::vector<u8> m_controls{};
+    std::vector<Slot> m_slots{};
+    size_t m_mask{};
+    size_t m_size{};
+};
+
+} // namespace mgpu
@@ -10,5 +10,7 @@ static constexpr size_t max_color_attachments = 8u;
 static constexpr size_t max_total_attachments = max_color_attachments + 1u;
 static constexpr size_t max_vertex_input_bindings = 32;
 static constexpr size_t max_vertex_input_attributes = 64;
+static constexpr size_t max_push_constants_size = 256u; // Push constants are stored inline in the command list.
+static constexpr size_t max_dynamic_buffer_bindings = 32u; // Dynamic offsets are stored inline in the command list.
 
 } // namespace mgpu::limits
@@ -27,4 +27,19 @@ MGPURenderCommandEncoder mgpuCommandListCmdBeginRenderPass(MGPUCommandList comma
   return (MGPURenderCommandEncoder)((mgpu::CommandList*)command_list)->CmdBeginRenderPass(*begin_info);
 }
 
+MGPUComputeCommandEncoder mgpuCommandListCmdBeginComputePass(MGPUCommandList command_list) {
+  return (MGPUComputeCommandEncoder)((mgpu::CommandList*)command_list)->CmdBeginComputePass();
+}
+
+void mgpuCommandListCmdAppendCommandList(MGPUCommandList command_list, MGPUCommandList child_command_list) {
+  ((mgpu::CommandList*)command_list)->CmdAppendCommandList((const mgpu::CommandList*)child_command_list);
+}
+
+void mgpuCommandListGetStatistics(MGPUCommandList command_list, MGPUCommandListStatistics* statistics) {
+  const auto& cxx_statistics = ((mgpu::CommandList*)command_list)->GetStatistics();
+
+  statistics->recorded_command_count = cxx_statistics.recorded_command_count;
+  statistics->elided_command_count = cxx_statistics.elided_command_count;
+}
+
 }  // extern "C"
@@ -0,0 +1,37 @@
+
+#include <mgpu/mgpu.h>
+
+#include "backend/command_list/compute_command_encoder.hpp"
+
+extern "C" {
+
+void mgpuComputeCommandEncoderCmdUseShaderProgram(MGPUComputeCommandEncoder compute_command_encoder, MGPUShaderProgram shader_program) {
+  ((mgpu::ComputeCommandEncoder*)compute_command_encoder)->CmdUseShaderProgram((mgpu::ShaderProgramBase*)shader_program);
+}
+
+void mgpuComputeCommandEncoderCmdBindResourceSet(MGPUComputeCommandEncoder compute_command_encoder, uint32_t index, MGPUResourceSet resource_set) {
+  // TODO(fleroviux): implement validation?
+  ((mgpu::ComputeCommandEncoder*)compute_command_encoder)->CmdBindResourceSet(index, (mgpu::ResourceSetBase*)resource_set, {});
+}
+
+void mgpuComputeCommandEncoderCmdBindResourceSetWithDynamicOffsets(MGPUComputeCommandEncoder compute_command_encoder, uint32_t index, MGPUResourceSet resource_set, uint32_t dynamic_offset_count, const uint32_t* dynamic_offsets) {
+  ((mgpu::ComputeCommandEncoder*)compute_command_encoder)->CmdBindResourceSet(index, (mgpu::ResourceSetBase*)resource_set, {dynamic_offsets, dynamic_offset_count});
+}
+
+void mgpuComputeCommandEncoderCmdPushConstants(MGPUComputeCommandEncoder compute_command_encoder, uint32_t offset, uint32_t size, const void* data) {
+  ((mgpu::ComputeCommandEncoder*)compute_command_encoder)->CmdPushConstants(offset, size, data);
+}
+
+void mgpuComputeCommandEncoderCmdDispatch(MGPUComputeCommandEncoder compute_command_encoder, uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) {
+  ((mgpu::ComputeCommandEncoder*)compute_command_encoder)->CmdDispatch(group_count_x, group_count_y, group_count_z);
+}
+
+void mgpuComputeCommandEncoderCmdDispatchIndirect(MGPUComputeCommandEncoder compute_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset) {
+  ((mgpu::ComputeCommandEncoder*)compute_command_encoder)->CmdDispatchIndirect((mgpu::BufferBase*)buffer, buffer_offset);
+}
+
+void mgpuComputeCommandEncoderClose(MGPUComputeCommandEncoder compute_command_encoder) {
+  ((mgpu::ComputeCommandEncoder*)compute_command_encoder)->Close();
+}
+
+} // extern "C"
@@ -10,6 +10,7 @@
 #include "backend/pipeline_state/shader_program.hpp"
 #include "backend/pipeline_state/vertex_input_state.hpp"
 #include "backend/buffer.hpp"
+#include "backend/command_bundle.hpp"
 #include "backend/device.hpp"
 #include "backend/instance.hpp"
 #include "backend/resource_set_layout.hpp"
@@ -63,29 +64,43 @@ void mgpuShaderProgramDestroy(MGPUShaderProgram shader_program) {
 }
 
 void mgpuRasterizerStateDestroy(MGPURasterizerState rasterizer_state) {
-  delete (mgpu::RasterizerStateBase*)rasterizer_state;
+  if(rasterizer_state != nullptr) {
+    ((mgpu::RasterizerStateBase*)rasterizer_state)->Release();
+  }
 }
 
 void mgpuInputAssemblyStateDestroy(MGPUInputAssemblyState input_assembly_state) {
-  delete (mgpu::InputAssemblyStateBase*)input_assembly_state;
+  if(input_assembly_state != nullptr) {
+    ((mgpu::InputAssemblyStateBase*)input_assembly_state)->Release();
+  }
 }
 
 void mgpuColorBlendStateDestroy(MGPUColorBlendState color_blend_state) {
-  delete (mgpu::ColorBlendStateBase*)color_blend_state;
+  if(color_blend_state != nullptr) {
+    ((mgpu::ColorBlendStateBase*)color_blend_state)->Release();
+  }
 }
 
 void mgpuVertexInputStateDestroy(MGPUVertexInputState vertex_input_state) {
-  delete (mgpu::VertexInputStateBase*)vertex_input_state;
+  if(vertex_input_state != nullptr) {
+    ((mgpu::VertexInputStateBase*)vertex_input_state)->Release();
+  }
 }
 
 void mgpuDepthStencilStateDestroy(MGPUDepthStencilState depth_stencil_state) {
-  delete (mgpu::DepthStencilStateBase*)depth_stencil_state;
+  if(depth_stencil_state != nullptr) {
+    ((mgpu::DepthStencilStateBase*)depth_stencil_state)->Release();
+  }
 }
 
 void mgpuCommandListDestroy(MGPUCommandList command_list) {
   delete (mgpu::CommandList*)command_list;
 }
 
+void mgpuCommandBundleDestroy(MGPUCommandBundle command_bundle) {
+  delete (mgpu::CommandBundleBase*)command_bundle;
+}
+
 void mgpuSurfaceDestroy(MGPUSurface surface) {
   delete (mgpu::SurfaceBase*)surface;
 }
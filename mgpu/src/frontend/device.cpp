@@ -1,10 +1,15 @@
 
 #include <mgpu/mgpu.h>
+#include <cstring>
 
 #include "backend/command_list/command_list.hpp"
+#include "backend/command_bundle.hpp"
 #include "backend/device.hpp"
 #include "backend/surface.hpp"
 #include "validation/buffer.hpp"
+#include "validation/command_bundle.hpp"
+#include "validation/device.hpp"
+#include "validation/resource_set_layout.hpp"
 #include "validation/sampler.hpp"
 #include "validation/shader_program.hpp"
 #include "validation/texture.hpp"
@@ -57,6 +62,8 @@ MGPUResult mgpuDeviceCreateSampler(MGPUDevice device, const MGPUSamplerCreateInf
 }
 
 MGPUResult mgpuDeviceCreateResourceSetLayout(MGPUDevice device, const MGPUResourceSetLayoutCreateInfo* create_info, MGPUResourceSetLayout* resource_set_layout) {
+  MGPU_FORWARD_ERROR(validate_resource_set_layout_create_info(*create_info));
+
   mgpu::Result<mgpu::ResourceSetLayoutBase*> cxx_resource_set_layout_result = ((mgpu::DeviceBase*)device)->CreateResourceSetLayout(*create_info);
   MGPU_FORWARD_ERROR(cxx_resource_set_layout_result.Code());
   *resource_set_layout = (MGPUResourceSetLayout)cxx_resource_set_layout_result.Unwrap();
@@ -79,6 +86,7 @@ MGPUResult mgpuDeviceCreateShaderModule(MGPUDevice device, const uint32_t* spirv
 
 MGPUResult mgpuDeviceCreateShaderProgram(MGPUDevice device, const MGPUShaderProgramCreateInfo* create_info, MGPUShaderProgram* shader_program) {
   MGPU_FORWARD_ERROR(validate_shader_program_stages(create_info));
+  MGPU_FORWARD_ERROR(validate_shader_program_push_constant_ranges(((mgpu::DeviceBase*)device)->Limits(), create_info));
 
   mgpu::Result<mgpu::ShaderProgramBase*> cxx_shader_program_result = ((mgpu::DeviceBase*)device)->CreateShaderProgram(*create_info);
   MGPU_FORWARD_ERROR(cxx_shader_program_result.Code());
@@ -138,6 +146,75 @@ MGPUResult mgpuDeviceCreateCommandList(MGPUDevice device, MGPUCommandList* comma
   return MGPU_SUCCESS;
 }
 
+MGPUResult mgpuDeviceCreateCommandBundle(MGPUDevice device, MGPUCommandList command_list, MGPUCommandBundle* command_bundle) {
+  const auto cxx_command_list = (const mgpu::CommandList*)command_list;
+
+  MGPU_FORWARD_ERROR(validate_command_bundle_command_list(cxx_command_list));
+
+  mgpu::Result<mgpu::CommandBundleBase*> cxx_command_bundle_result = ((mgpu::DeviceBase*)device)->CreateCommandBundle(cxx_command_list);
+  MGPU_FORWARD_ERROR(cxx_command_bundle_result.Code());
+  *command_bundle = (MGPUCommandBundle)cxx_command_bundle_result.Unwrap();
+  return MGPU_SUCCESS;
+}
+
+MGPUResult mgpuDeviceGetPipelineCacheData(MGPUDevice device, size_t* data_size, void* data) {
+  const size_t max_data_size = *data_size;
+
+  mgpu::Result<std::vector<u8>> data_result = ((mgpu::DeviceBase*)device)->GetPipelineCacheData();
+  MGPU_FORWARD_ERROR(data_result.Code());
+
+  const std::vector<u8> data_vector = data_result.Unwrap();
+
+  *data_size = data_vector.size();
+  if(data != nullptr) {
+    // A truncated pipeline cache is useless, so unlike in the enumeration methods nothing is copied in that case.
+    if(max_data_size < data_vector.size()) {
+      return MGPU_INCOMPLETE;
+    }
+    std::memcpy(data, data_vector.data(), data_vector.size());
+  }
+  return MGPU_SUCCESS;
+}
+
+MGPUResult mgpuDeviceSetFallbackShaderProgram(MGPUDevice device, MGPUShaderProgram shader_program) {
+  // A null handle removes the fallback shader program.
+  ((mgpu::DeviceBase*)device)->SetFallbackShaderProgram((mgpu::ShaderProgramBase*)shader_program);
+  return MGPU_SUCCESS;
+}
+
+uint32_t mgpuDeviceGetPendingPipelineCompilationCount(MGPUDevice device) {
+  return ((mgpu::DeviceBase*)device)->GetPendingPipelineCompilationCount();
+}
+
+MGPUResult mgpuDevicePrecompilePipelines(MGPUDevice device, uint32_t pipeline_count, const MGPUGraphicsPipelineInfo* pipelines) {
+  const auto cxx_device = (mgpu::DeviceBase*)device;
+
+  std::vector<MGPUGraphicsPipelineInfo> pipeline_infos{pipelines, pipelines + pipeline_count};
+
+  // Fill in the same default states that a render pass starts out with, so that the pipelines match those used by the draws.
+  for(MGPUGraphicsPipelineInfo& pipeline_info : pipeline_infos) {
+    MGPU_FORWARD_ERROR(validate_graphics_pipeline_info(pipeline_info));
+
+    if(pipeline_info.rasterizer_state == MGPU_NULL_HANDLE) {
+      pipeline_info.rasterizer_state = (MGPURasterizerState)cxx_device->GetDefaultRasterizerState();
+    }
+    if(pipeline_info.input_assembly_state == MGPU_NULL_HANDLE) {
+      pipeline_info.input_assembly_state = (MGPUInputAssemblyState)cxx_device->GetDefaultInputAssemblyState();
+    }
+    if(pipeline_info.color_blend_state == MGPU_NULL_HANDLE) {
+      pipeline_info.color_blend_state = (MGPUColorBlendState)cxx_device->GetDefaultColorBlendState(pipeline_info.render_pass.color_attachment_count);
+    }
+    if(pipeline_info.vertex_input_state == MGPU_NULL_HANDLE) {
+      pipeline_info.vertex_input_state = (MGPUVertexInputState)cxx_device->GetDefaultVertexInputState();
+    }
+    if(pipeline_info.depth_stencil_state == MGPU_NULL_HANDLE) {
+      pipeline_info.depth_stencil_state = (MGPUDepthStencilState)cxx_device->GetDefaultDepthStencilState();
+    }
+  }
+
+  return cxx_device->PrecompileGraphicsPipelines(pipeline_infos);
+}
+
 MGPUResult mgpuDeviceCreateSwapChain(MGPUDevice device, const MGPUSwapChainCreateInfo* create_info, MGPUSwapChain* swap_chain) {
   // TODO(fleroviux): implement input validation
   mgpu::Result<mgpu::SwapChainBase*> cxx_swap_chain_result = ((mgpu::DeviceBase*)device)->CreateSwapChain(*create_info);
@@ -5,6 +5,7 @@
 #include <limits>
 #include <vector>
 
+#include "backend/null/instance.hpp"
 #include "backend/vulkan/instance.hpp"
 #include "backend/physical_device.hpp"
 
@@ -15,6 +16,7 @@ MGPUResult mgpuCreateInstance(MGPUBackendType backend_type, MGPUInstance* instan
 
   switch(backend_type) {
     case MGPU_BACKEND_TYPE_VULKAN: cxx_instance_result = mgpu::vulkan::Instance::Create(); break;
+    case MGPU_BACKEND_TYPE_NULL: cxx_instance_result = mgpu::null::Instance::Create(); break;
     default: break;
   }
 
@@ -4,6 +4,7 @@
 #include <limits>
 
 #include "backend/physical_device.hpp"
+#include "validation/device.hpp"
 
 extern "C" {
 
@@ -63,8 +64,10 @@ MGPUResult mgpuPhysicalDeviceEnumerateSurfacePresentModes(MGPUPhysicalDevice phy
   return MGPU_SUCCESS;
 }
 
-MGPUResult mgpuPhysicalDeviceCreateDevice(MGPUPhysicalDevice physical_device, MGPUDevice* device) {
-  mgpu::Result<mgpu::DeviceBase*> cxx_device_result = ((mgpu::PhysicalDeviceBase*)physical_device)->CreateDevice();
+MGPUResult mgpuPhysicalDeviceCreateDevice(MGPUPhysicalDevice physical_device, const MGPUDeviceCreateInfo* create_info, MGPUDevice* device) {
+  MGPU_FORWARD_ERROR(validate_device_create_info(*create_info));
+
+  mgpu::Result<mgpu::DeviceBase*> cxx_device_result = ((mgpu::PhysicalDeviceBase*)physical_device)->CreateDevice(*create_info);
 
   MGPU_FORWARD_ERROR(cxx_device_result.Code());
   *device = (MGPUDevice)cxx_device_result.Unwrap();
@@ -1,5 +1,6 @@
 
 #include <mgpu/mgpu.h>
+#include <bit>
 
 #include "backend/queue.hpp"
 #include "validation/buffer.hpp"
@@ -35,6 +36,37 @@ MGPUResult mgpuQueueTextureUpload(MGPUQueue queue, MGPUTexture texture, const MG
   return cxx_queue->TextureUpload(cxx_texture, *region, data);
 }
 
+MGPUResult mgpuQueueCreateTransientResourceSet(MGPUQueue queue, const MGPUResourceSetCreateInfo* create_info, MGPUResourceSet* resource_set) {
+  mgpu::Result<mgpu::ResourceSetBase*> cxx_resource_set_result = ((mgpu::QueueBase*)queue)->CreateTransientResourceSet(*create_info);
+  MGPU_FORWARD_ERROR(cxx_resource_set_result.Code());
+  *resource_set = (MGPUResourceSet)cxx_resource_set_result.Unwrap();
+  return MGPU_SUCCESS;
+}
+
+MGPUResult mgpuQueueAllocateTransient(MGPUQueue queue, uint64_t size, uint64_t alignment, MGPUBufferUsage usage, MGPUTransientAllocation* allocation) {
+  const auto cxx_queue = (mgpu::QueueBase*)queue;
+
+  MGPU_FORWARD_ERROR(validate_buffer_size(size));
+  MGPU_FORWARD_ERROR(validate_buffer_usage(usage));
+  if((usage & mgpu::QueueBase::k_transient_buffer_usage) != usage) {
+    return MGPU_BUFFER_INCOMPATIBLE;
+  }
+  if(alignment == 0u || !std::has_single_bit(alignment)) {
+    return MGPU_BAD_DIMENSIONS;
+  }
+
+  mgpu::Result<mgpu::QueueBase::TransientAllocation> cxx_allocation_result = cxx_queue->AllocateTransient(size, alignment, usage);
+  MGPU_FORWARD_ERROR(cxx_allocation_result.Code());
+
+  const mgpu::QueueBase::TransientAllocation cxx_allocation = cxx_allocation_result.Unwrap();
+  *allocation = {
+    .buffer = (MGPUBuffer)cxx_allocation.buffer,
+    .offset = cxx_allocation.offset,
+    .address = cxx_allocation.address
+  };
+  return MGPU_SUCCESS;
+}
+
 MGPUResult mgpuQueueFlush(MGPUQueue queue) {
   return ((mgpu::QueueBase*)queue)->Flush();
 }
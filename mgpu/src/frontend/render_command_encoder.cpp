@@ -2,6 +2,7 @@
 #include <mgpu/mgpu.h>
 
 #include "backend/command_list/render_command_encoder.hpp"
+#include "backend/command_bundle.hpp"
 
 extern "C" {
 
@@ -52,7 +53,15 @@ void mgpuRenderCommandEncoderCmdBindIndexBuffer(MGPURenderCommandEncoder render_
 
 void mgpuRenderCommandEncoderCmdBindResourceSet(MGPURenderCommandEncoder render_command_encoder, uint32_t index, MGPUResourceSet resource_set) {
   // TODO(fleroviux): implement validation?
-  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdBindResourceSet(index, (mgpu::ResourceSetBase*)resource_set);
+  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdBindResourceSet(index, (mgpu::ResourceSetBase*)resource_set, {});
+}
+
+void mgpuRenderCommandEncoderCmdBindResourceSetWithDynamicOffsets(MGPURenderCommandEncoder render_command_encoder, uint32_t index, MGPUResourceSet resource_set, uint32_t dynamic_offset_count, const uint32_t* dynamic_offsets) {
+  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdBindResourceSet(index, (mgpu::ResourceSetBase*)resource_set, {dynamic_offsets, dynamic_offset_count});
+}
+
+void mgpuRenderCommandEncoderCmdPushConstants(MGPURenderCommandEncoder render_command_encoder, uint32_t offset, uint32_t size, const void* data) {
+  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdPushConstants(offset, size, data);
 }
 
 void mgpuRenderCommandEncoderCmdDraw(MGPURenderCommandEncoder render_command_encoder, uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) {
@@ -66,6 +75,28 @@ void mgpuRenderCommandEncoderCmdDrawIndexed(MGPURenderCommandEncoder render_comm
   ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdDrawIndexed(index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
+void mgpuRenderCommandEncoderCmdDrawIndirect(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, uint32_t draw_count, uint32_t stride) {
+  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdDrawIndirect((mgpu::BufferBase*)buffer, buffer_offset, nullptr, 0u, draw_count, stride);
+}
+
+void mgpuRenderCommandEncoderCmdDrawIndexedIndirect(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, uint32_t draw_count, uint32_t stride) {
+  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdDrawIndexedIndirect((mgpu::BufferBase*)buffer, buffer_offset, nullptr, 0u, draw_count, stride);
+}
+
+void mgpuRenderCommandEncoderCmdDrawIndirectCount(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, MGPUBuffer count_buffer, uint64_t count_buffer_offset, uint32_t max_draw_count, uint32_t stride) {
+  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdDrawIndirect(
+    (mgpu::BufferBase*)buffer, buffer_offset, (mgpu::BufferBase*)count_buffer, count_buffer_offset, max_draw_count, stride);
+}
+
+void mgpuRenderCommandEncoderCmdDrawIndexedIndirectCount(MGPURenderCommandEncoder render_command_encoder, MGPUBuffer buffer, uint64_t buffer_offset, MGPUBuffer count_buffer, uint64_t count_buffer_offset, uint32_t max_draw_count, uint32_t stride) {
+  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdDrawIndexedIndirect(
+    (mgpu::BufferBase*)buffer, buffer_offset, (mgpu::BufferBase*)count_buffer, count_buffer_offset, max_draw_count, stride);
+}
+
+
+void mgpuRenderCommandEncoderCmdExecuteCommandBundle(MGPURenderCommandEncoder render_command_encoder, MGPUCommandBundle command_bundle) {
+  ((mgpu::RenderCommandEncoder*)render_command_encoder)->CmdExecuteCommandBundle((const mgpu::CommandBundleBase*)command_bundle);
+}
 
 void mgpuRenderCommandEncoderClose(MGPURenderCommandEncoder render_command_encoder) {
   ((mgpu::RenderCommandEncoder*)render_command_encoder)->Close();
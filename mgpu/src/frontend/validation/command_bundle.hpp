@@ -0,0 +1,39 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+#include <atom/integer.hpp>
+
+#include "backend/command_list/command_list.hpp"
+
+inline MGPUResult validate_command_bundle_command_list(const mgpu::CommandList* command_list) {
+  if(command_list->HasErrors()) {
+    return MGPU_BAD_COMMAND_LIST;
+  }
+
+  // A command bundle is recorded as a command list with exactly one render pass, which must not execute other bundles.
+  // Compute passes cannot be recorded into command bundles.
+  size_t render_pass_count = 0u;
+
+  for(const mgpu::CommandBase& command : *command_list) {
+    switch(command.m_command_type) {
+      case mgpu::CommandType::BeginRenderPass: {
+        render_pass_count++;
+        break;
+      }
+      case mgpu::CommandType::ExecuteCommandBundle:
+      case mgpu::CommandType::AppendCommandList:
+      case mgpu::CommandType::BeginComputePass: {
+        return MGPU_BAD_COMMAND_LIST;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+
+  if(render_pass_count != 1u) {
+    return MGPU_BAD_COMMAND_LIST;
+  }
+  return MGPU_SUCCESS;
+}
@@ -0,0 +1,28 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+
+#include "common/limits.hpp"
+
+inline MGPUResult validate_device_create_info(const MGPUDeviceCreateInfo& create_info) {
+  if(create_info.pipeline_cache_size != 0u && create_info.pipeline_cache_data == nullptr) {
+    return MGPU_INVALID_ARGUMENT;
+  }
+  return MGPU_SUCCESS;
+}
+
+inline MGPUResult validate_graphics_pipeline_info(const MGPUGraphicsPipelineInfo& pipeline_info) {
+  if(pipeline_info.shader_program == MGPU_NULL_HANDLE) {
+    return MGPU_INVALID_ARGUMENT;
+  }
+
+  const MGPURenderPassInfo& render_pass_info = pipeline_info.render_pass;
+  if(render_pass_info.color_attachment_count > mgpu::limits::max_color_attachments) {
+    return MGPU_INVALID_ARGUMENT;
+  }
+  if(render_pass_info.color_attachment_count > 0u && render_pass_info.color_attachments == nullptr) {
+    return MGPU_INVALID_ARGUMENT;
+  }
+  return MGPU_SUCCESS;
+}
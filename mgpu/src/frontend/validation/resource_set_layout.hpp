@@ -0,0 +1,25 @@
+
+#pragma once
+
+#include <mgpu/mgpu.h>
+
+#include "common/limits.hpp"
+
+inline MGPUResult validate_resource_set_layout_create_info(const MGPUResourceSetLayoutCreateInfo& create_info) {
+  if(create_info.binding_count > 0u && create_info.bindings == nullptr) {
+    return MGPU_INVALID_ARGUMENT;
+  }
+
+  // Dynamic offsets are recorded inline when binding a resource set, so their number must be bounded.
+  size_t dynamic_binding_count = 0u;
+  for(size_t i = 0u; i < create_info.binding_count; i++) {
+    const MGPUResourceBindingType type = create_info.bindings[i].type;
+    if(type == MGPU_RESOURCE_BINDING_TYPE_UNIFORM_BUFFER_DYNAMIC || type == MGPU_RESOURCE_BINDING_TYPE_STORAGE_BUFFER_DYNAMIC) {
+      dynamic_binding_count++;
+    }
+  }
+  if(dynamic_binding_count > mgpu::limits::max_dynamic_buffer_bindings) {
+    return MGPU_INVALID_ARGUMENT;
+  }
+  return MGPU_SUCCESS;
+}
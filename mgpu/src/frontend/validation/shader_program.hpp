@@ -27,4 +27,23 @@ inline MGPUResult validate_shader_program_stages(const MGPUShaderProgramCreateIn
   }
 
   return MGPU_SUCCESS;
-}
\ No newline at end of file
+}
+
+inline MGPUResult validate_shader_program_push_constant_ranges(const MGPUPhysicalDeviceLimits& limits, const MGPUShaderProgramCreateInfo* create_info) {
+  for(size_t i = 0; i < create_info->push_constant_range_count; i++) {
+    const MGPUPushConstantRange& push_constant_range = create_info->push_constant_ranges[i];
+
+    if(
+      push_constant_range.stages == 0 ||
+      push_constant_range.size == 0u ||
+      push_constant_range.offset % sizeof(uint32_t) != 0u ||
+      push_constant_range.size % sizeof(uint32_t) != 0u ||
+      push_constant_range.size > limits.max_push_constants_size ||
+      push_constant_range.offset > limits.max_push_constants_size - push_constant_range.size
+    ) {
+      return MGPU_INVALID_ARGUMENT;
+    }
+  }
+
+  return MGPU_SUCCESS;
+}
@@ -146,7 +146,8 @@ int main() {
   }
 
   MGPUDevice mgpu_device{};
-  MGPU_CHECK(mgpuPhysicalDeviceCreateDevice(mgpu_physical_device, &mgpu_device));
+  const MGPUDeviceCreateInfo device_create_info{};
+  MGPU_CHECK(mgpuPhysicalDeviceCreateDevice(mgpu_physical_device, &device_create_info, &mgpu_device));
 
   MGPUSwapChain mgpu_swap_chain{};
   std::vector<MGPUTexture> mgpu_swap_chain_textures{};
@@ -60,7 +60,13 @@ Application::Application() {
   if(m_mgpu_physical_device == MGPU_NULL_HANDLE) {
     ATOM_PANIC("failed to find a suitable MGPU physical device");
   }
-  MGPU_CHECK(mgpuPhysicalDeviceCreateDevice(m_mgpu_physical_device, &m_mgpu_device));
+  // Keep compiled pipelines around across runs, so that subsequent runs start faster.
+  const MGPUDeviceCreateInfo device_create_info{
+    .pipeline_cache_path = "hello-cube.pipeline_cache",
+    .pipeline_cache_data = nullptr,
+    .pipeline_cache_size = 0u
+  };
+  MGPU_CHECK(mgpuPhysicalDeviceCreateDevice(m_mgpu_physical_device, &device_create_info, &m_mgpu_device));
 
   CreateSwapChain();
 
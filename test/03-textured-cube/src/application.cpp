@@ -60,7 +60,8 @@ Application::Application() {
   if(m_mgpu_physical_device == MGPU_NULL_HANDLE) {
     ATOM_PANIC("failed to find a suitable MGPU physical device");
   }
-  MGPU_CHECK(mgpuPhysicalDeviceCreateDevice(m_mgpu_physical_device, &m_mgpu_device));
+  const MGPUDeviceCreateInfo device_create_info{};
+  MGPU_CHECK(mgpuPhysicalDeviceCreateDevice(m_mgpu_physical_device, &device_create_info, &m_mgpu_device));
 
   CreateSwapChain();
 
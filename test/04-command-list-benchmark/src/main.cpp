@@ -0,0 +1,214 @@
+
+#include <mgpu/mgpu.h>
+
+#include <atom/float.hpp>
+#include <atom/integer.hpp>
+#include <atom/panic.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define MGPU_CHECK(result_expression) \
+  do { \
+    MGPUResult result = result_expression; \
+    if(result != MGPU_SUCCESS) \
+      ATOM_PANIC("MGPU error: {} ({})", "" # result_expression, mgpuResultCodeToString(result)); \
+  } while(0)
+
+// Measures the CPU cost of recording and submitting a large command list.
+// The null backend is used, so that no time is spent translating the commands for an actual GPU.
+// The draws are recorded once on a single thread and once split across multiple views,
+// which are recorded into child command lists on separate threads and then appended to the main command list.
+// Finally, the draws are baked into a command bundle once, which then is executed every frame.
+
+static constexpr u32 k_draw_count = 50000u;
+static constexpr u32 k_view_count = 8u;
+static constexpr u32 k_frame_count = 100u;
+
+int main() {
+  MGPUInstance mgpu_instance{};
+  MGPU_CHECK(mgpuCreateInstance(MGPU_BACKEND_TYPE_NULL, &mgpu_instance));
+
+  MGPUPhysicalDevice mgpu_physical_device{};
+  MGPU_CHECK(mgpuInstanceSelectPhysicalDevice(mgpu_instance, MGPU_POWER_PREFERENCE_HIGH_PERFORMANCE, &mgpu_physical_device));
+
+  MGPUDevice mgpu_device{};
+  const MGPUDeviceCreateInfo device_create_info{};
+  MGPU_CHECK(mgpuPhysicalDeviceCreateDevice(mgpu_physical_device, &device_create_info, &mgpu_device));
+
+  const MGPUTextureCreateInfo render_target_create_info{
+    .format = MGPU_TEXTURE_FORMAT_B8G8R8A8_SRGB,
+    .type = MGPU_TEXTURE_TYPE_2D,
+    .extent = {
+      .width = 1920u,
+      .height = 1080u,
+      .depth = 1u
+    },
+    .mip_count = 1u,
+    .array_layer_count = 1u,
+    .usage = MGPU_TEXTURE_USAGE_RENDER_ATTACHMENT
+  };
+  MGPUTexture mgpu_render_target{};
+  MGPU_CHECK(mgpuDeviceCreateTexture(mgpu_device, &render_target_create_info, &mgpu_render_target));
+
+  const MGPUTextureViewCreateInfo render_target_view_create_info{
+    .type = MGPU_TEXTURE_VIEW_TYPE_2D,
+    .format = MGPU_TEXTURE_FORMAT_B8G8R8A8_SRGB,
+    .aspect = MGPU_TEXTURE_ASPECT_COLOR,
+    .base_mip = 0u,
+    .mip_count = 1u,
+    .base_array_layer = 0u,
+    .array_layer_count = 1u
+  };
+  MGPUTextureView mgpu_render_target_view{};
+  MGPU_CHECK(mgpuTextureCreateView(mgpu_render_target, &render_target_view_create_info, &mgpu_render_target_view));
+
+  const MGPUBufferCreateInfo vbo_create_info{
+    .size = 65536u,
+    .usage = MGPU_BUFFER_USAGE_VERTEX_BUFFER,
+    .flags = 0
+  };
+  MGPUBuffer mgpu_vbos[2]{};
+  MGPU_CHECK(mgpuDeviceCreateBuffer(mgpu_device, &vbo_create_info, &mgpu_vbos[0]));
+  MGPU_CHECK(mgpuDeviceCreateBuffer(mgpu_device, &vbo_create_info, &mgpu_vbos[1]));
+
+  const MGPUBufferCreateInfo ibo_create_info{
+    .size = 65536u,
+    .usage = MGPU_BUFFER_USAGE_INDEX_BUFFER,
+    .flags = 0
+  };
+  MGPUBuffer mgpu_ibo{};
+  MGPU_CHECK(mgpuDeviceCreateBuffer(mgpu_device, &ibo_create_info, &mgpu_ibo));
+
+  MGPUCommandList mgpu_cmd_list{};
+  MGPU_CHECK(mgpuDeviceCreateCommandList(mgpu_device, &mgpu_cmd_list));
+
+  MGPUCommandList mgpu_view_cmd_lists[k_view_count]{};
+  for(auto& mgpu_view_cmd_list : mgpu_view_cmd_lists) {
+    MGPU_CHECK(mgpuDeviceCreateCommandList(mgpu_device, &mgpu_view_cmd_list));
+  }
+
+  MGPUQueue mgpu_queue = mgpuDeviceGetQueue(mgpu_device, MGPU_QUEUE_TYPE_GRAPHICS_COMPUTE);
+
+  const MGPURenderPassColorAttachment render_pass_color_attachments[1] {
+    {
+      .texture_view = mgpu_render_target_view,
+      .load_op = MGPU_LOAD_OP_CLEAR,
+      .store_op = MGPU_STORE_OP_STORE,
+      .clear_color = {.r = 0.f, .g = 0.f, .b = 0.f, .a = 1.f}
+    }
+  };
+  const MGPURenderPassBeginInfo render_pass_info{
+    .color_attachment_count = 1u,
+    .color_attachments = render_pass_color_attachments,
+    .depth_stencil_attachment = nullptr
+  };
+
+  const auto RecordDraws = [&](MGPUCommandList cmd_list, u32 draw_count) {
+    MGPURenderCommandEncoder render_cmd_encoder = mgpuCommandListCmdBeginRenderPass(cmd_list, &render_pass_info);
+    for(u32 draw = 0u; draw < draw_count; draw++) {
+      // Mimic a scene graph which binds the full state for every draw, whether it changed or not.
+      mgpuRenderCommandEncoderCmdBindIndexBuffer(render_cmd_encoder, mgpu_ibo, 0u, MGPU_INDEX_FORMAT_U16);
+      mgpuRenderCommandEncoderCmdBindVertexBuffer(render_cmd_encoder, 0u, mgpu_vbos[draw & 1u], 0u);
+      mgpuRenderCommandEncoderCmdDrawIndexed(render_cmd_encoder, 36u, 1u, 0u, 0, 0u);
+    }
+    mgpuRenderCommandEncoderClose(render_cmd_encoder);
+  };
+
+  const auto RecordSingleThreaded = [&]() {
+    MGPU_CHECK(mgpuCommandListClear(mgpu_cmd_list));
+    RecordDraws(mgpu_cmd_list, k_draw_count);
+  };
+
+  const auto RecordMultiThreaded = [&]() {
+    std::vector<std::thread> threads{};
+
+    for(MGPUCommandList mgpu_view_cmd_list : mgpu_view_cmd_lists) {
+      threads.emplace_back([&, mgpu_view_cmd_list]() {
+        MGPU_CHECK(mgpuCommandListClear(mgpu_view_cmd_list));
+        RecordDraws(mgpu_view_cmd_list, k_draw_count / k_view_count);
+      });
+    }
+
+    // The views end up in the command list in this order, regardless of which thread finishes recording first.
+    MGPU_CHECK(mgpuCommandListClear(mgpu_cmd_list));
+    for(MGPUCommandList mgpu_view_cmd_list : mgpu_view_cmd_lists) {
+      mgpuCommandListCmdAppendCommandList(mgpu_cmd_list, mgpu_view_cmd_list);
+    }
+
+    for(auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  MGPUCommandBundle mgpu_cmd_bundle{};
+  MGPU_CHECK(mgpuCommandListClear(mgpu_cmd_list));
+  RecordDraws(mgpu_cmd_list, k_draw_count);
+  MGPU_CHECK(mgpuDeviceCreateCommandBundle(mgpu_device, mgpu_cmd_list, &mgpu_cmd_bundle));
+
+  const auto RecordCommandBundle = [&]() {
+    MGPU_CHECK(mgpuCommandListClear(mgpu_cmd_list));
+    MGPURenderCommandEncoder render_cmd_encoder = mgpuCommandListCmdBeginRenderPass(mgpu_cmd_list, &render_pass_info);
+    mgpuRenderCommandEncoderCmdExecuteCommandBundle(render_cmd_encoder, mgpu_cmd_bundle);
+    mgpuRenderCommandEncoderClose(render_cmd_encoder);
+  };
+
+  const auto RunBenchmark = [&](const char* name, auto record) {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::duration record_time{};
+    Clock::duration submit_time{};
+
+    for(u32 frame = 0u; frame < k_frame_count; frame++) {
+      const Clock::time_point t0 = Clock::now();
+
+      record();
+
+      const Clock::time_point t1 = Clock::now();
+
+      MGPU_CHECK(mgpuQueueSubmitCommandList(mgpu_queue, mgpu_cmd_list));
+      MGPU_CHECK(mgpuQueueFlush(mgpu_queue));
+
+      const Clock::time_point t2 = Clock::now();
+
+      // Skip the first frame, since it includes the cost of growing the command lists.
+      if(frame != 0u) {
+        record_time += t1 - t0;
+        submit_time += t2 - t1;
+      }
+    }
+
+    const auto ToMicroseconds = [](Clock::duration duration) {
+      return (f64)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 1000.0 / (k_frame_count - 1u);
+    };
+
+    fmt::print("{}:\n", name);
+    fmt::print("  record: {:.1f} us/frame\n", ToMicroseconds(record_time));
+    fmt::print("  submit: {:.1f} us/frame\n", ToMicroseconds(submit_time));
+  };
+
+  fmt::print("draws per frame: {}\n", k_draw_count);
+
+  RunBenchmark("single-threaded", RecordSingleThreaded);
+
+  MGPUCommandListStatistics statistics{};
+  mgpuCommandListGetStatistics(mgpu_cmd_list, &statistics);
+  fmt::print("  commands per frame: {} recorded, {} elided\n", statistics.recorded_command_count, statistics.elided_command_count);
+
+  RunBenchmark(fmt::format("{} views on {} threads", k_view_count, k_view_count).c_str(), RecordMultiThreaded);
+  RunBenchmark("command bundle", RecordCommandBundle);
+
+  mgpuCommandBundleDestroy(mgpu_cmd_bundle);
+  for(MGPUCommandList mgpu_view_cmd_list : mgpu_view_cmd_lists) {
+    mgpuCommandListDestroy(mgpu_view_cmd_list);
+  }
+  mgpuCommandListDestroy(mgpu_cmd_list);
+  mgpuBufferDestroy(mgpu_ibo);
+  mgpuBufferDestroy(mgpu_vbos[0]);
+  mgpuBufferDestroy(mgpu_vbos[1]);
+  mgpuTextureViewDestroy(mgpu_render_target_view);
+  mgpuTextureDestroy(mgpu_render_target);
+  mgpuDeviceDestroy(mgpu_device);
+  mgpuInstanceDestroy(mgpu_instance);
+  return 0;
+}
@@ -0,0 +1,100 @@
+
+#include <atom/float.hpp>
+#include <atom/hash.hpp>
+#include <atom/integer.hpp>
+#include <atom/panic.hpp>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "common/flat_hash_map.hpp"
+
+// Compares the lookup performance of mgpu's flat hash map against std::unordered_map.
+// The keys mimic the graphics pipeline cache queries of the Vulkan backend, which consist of seven state object pointers.
+// Lookups are done in a random order, like the state changes of a frame which draws many different materials,
+// but each key is looked up a few times in a row, like consecutive draws which share the same material.
+
+static constexpr u32 k_key_count = 1024u;
+static constexpr u32 k_lookup_count = 10000000u;
+
+struct Query {
+  struct Hasher {
+    size_t operator()(const Query& query) const {
+      size_t hash = 0u;
+      for(const void* pointer : query.m_pointers) {
+        atom::hash_combine(hash, pointer);
+      }
+      return hash;
+    }
+  };
+
+  const void* m_pointers[7]{};
+
+  [[nodiscard]] bool operator==(const Query& other_query) const {
+    for(size_t i = 0; i < 7u; i++) {
+      if(m_pointers[i] != other_query.m_pointers[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+int main() {
+  using Clock = std::chrono::steady_clock;
+
+  std::mt19937_64 random{12345u};
+
+  // Generate keys which look like heap pointers, that is they are aligned and close to each other.
+  std::vector<Query> queries{};
+  for(u32 i = 0u; i < k_key_count; i++) {
+    Query query{};
+    for(const void*& pointer : query.m_pointers) {
+      pointer = (const void*)(0x7F0000000000ull + (random() % 4096u) * 64u);
+    }
+    queries.push_back(query);
+  }
+
+  std::vector<u32> lookup_indices{};
+  while(lookup_indices.size() < k_lookup_count) {
+    const u32 key_index = (u32)(random() % k_key_count);
+    const u32 repeat_count = 1u + (u32)(random() % 4u);
+    for(u32 i = 0u; i < repeat_count && lookup_indices.size() < k_lookup_count; i++) {
+      lookup_indices.push_back(key_index);
+    }
+  }
+
+  std::unordered_map<Query, u64, Query::Hasher> unordered_map{};
+  mgpu::FlatHashMap<Query, u64> flat_hash_map{};
+
+  for(u32 i = 0u; i < k_key_count; i++) {
+    unordered_map[queries[i]] = i;
+    *flat_hash_map.TryEmplace(queries[i], Query::Hasher{}(queries[i])).first = i;
+  }
+
+  const auto RunBenchmark = [&](const char* name, auto lookup) {
+    u64 checksum = 0u;
+
+    const Clock::time_point t0 = Clock::now();
+    for(u32 lookup_index : lookup_indices) {
+      checksum += lookup(queries[lookup_index]);
+    }
+    const Clock::time_point t1 = Clock::now();
+
+    const f64 time = (f64)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / k_lookup_count;
+    fmt::print("{}: {:.1f} ns/lookup (checksum: {})\n", name, time, checksum);
+  };
+
+  fmt::print("keys: {}, lookups: {}\n", k_key_count, k_lookup_count);
+
+  RunBenchmark("std::unordered_map", [&](const Query& query) {
+    return unordered_map.find(query)->second;
+  });
+
+  RunBenchmark("mgpu::FlatHashMap", [&](const Query& query) {
+    return *flat_hash_map.Find(query, Query::Hasher{}(query));
+  });
+
+  return 0;
+}